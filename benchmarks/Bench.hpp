@@ -0,0 +1,48 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <benchmark/benchmark.h>
+
+/**
+ * @brief Components used by the benchmarks, one type per position so several can be joined.
+ */
+template<std::size_t I>
+struct bench_component {
+    float value;
+
+    bench_component(float v) noexcept :
+        value(v)
+    {}
+};
+
+/**
+ * @brief Entity counts measured by every benchmark: 10k, 100k, 1M and 10M.
+ */
+inline void entity_counts(benchmark::internal::Benchmark *b)
+{
+    for (std::int64_t n = 10000; n <= 10000000; n *= 10)
+        b->Arg(n);
+}
+
+/**
+ * @brief Entity counts crossed with the percentage of entities owning the joined components.
+ */
+inline void entity_counts_and_densities(benchmark::internal::Benchmark *b)
+{
+    for (std::int64_t n = 10000; n <= 10000000; n *= 10)
+        for (std::int64_t density : { 100, 50, 10, 1 })
+            b->Args({ n, density });
+}
+
+/**
+ * @brief Tells whether the entity at a given index owns the joined components, spreading the entities owning them
+ * evenly over the range.
+ */
+inline bool owns(std::size_t index, std::int64_t density) noexcept
+{
+    return (index * static_cast<std::size_t>(density)) % 100 < static_cast<std::size_t>(density);
+}
+
+#endif //BENCH_HPP
@@ -0,0 +1,160 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <registry.hpp>
+#include "Bench.hpp"
+
+/**
+ * @brief One-frame events, removed one by one or stored in a transient_set cleared by run_systems.
+ */
+template<>
+struct ecs::component_storage<bench_component<8>>
+{
+    using type = ecs::containers::sparse_set<bench_component<8>>;
+};
+
+template<>
+struct ecs::component_storage<bench_component<9>>
+{
+    using type = ecs::containers::transient_set<bench_component<9>>;
+};
+
+namespace
+{
+    std::vector<ecs::entity> spawn(ecs::registry &registry, std::size_t n)
+    {
+        std::vector<ecs::entity> entities;
+
+        entities.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            entities.push_back(registry.spawn_entity());
+        return entities;
+    }
+
+    std::vector<ecs::entity> shuffled(std::vector<ecs::entity> entities)
+    {
+        std::shuffle(entities.begin(), entities.end(), std::mt19937(42));
+        return entities;
+    }
+}
+
+static void add_component(benchmark::State &state)
+{
+    ecs::registry registry;
+    auto const entities = spawn(registry, static_cast<std::size_t>(state.range(0)));
+
+    registry.register_component<bench_component<0>>();
+    for (auto _ : state) {
+        for (auto const &e : entities)
+            registry.add_component<bench_component<0>>(e, { 1 });
+        state.PauseTiming();
+        registry.get_component<bench_component<0>>() = {};
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(add_component)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+static void emplace_component(benchmark::State &state)
+{
+    ecs::registry registry;
+    auto const entities = spawn(registry, static_cast<std::size_t>(state.range(0)));
+
+    registry.register_component<bench_component<0>>();
+    for (auto _ : state) {
+        for (auto const &e : entities)
+            registry.emplace_component<bench_component<0>>(e, 1.f);
+        state.PauseTiming();
+        registry.get_component<bench_component<0>>() = {};
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(emplace_component)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+static void remove_component(benchmark::State &state)
+{
+    ecs::registry registry;
+    auto const entities = spawn(registry, static_cast<std::size_t>(state.range(0)));
+
+    registry.register_component<bench_component<0>>();
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (auto const &e : entities)
+            registry.emplace_component<bench_component<0>>(e, 1.f);
+        state.ResumeTiming();
+        for (auto const &e : entities)
+            registry.remove_component<bench_component<0>>(e);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(remove_component)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+static void event_churn_remove(benchmark::State &state)
+{
+    ecs::registry registry;
+    auto const entities = spawn(registry, static_cast<std::size_t>(state.range(0)));
+
+    registry.register_component<bench_component<8>>();
+    for (auto _ : state) {
+        for (auto const &e : entities)
+            registry.emplace_component<bench_component<8>>(e, 1.f);
+        for (auto const &e : entities)
+            registry.remove_component<bench_component<8>>(e);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(event_churn_remove)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+static void event_churn_transient(benchmark::State &state)
+{
+    ecs::registry registry;
+    auto const entities = spawn(registry, static_cast<std::size_t>(state.range(0)));
+
+    registry.register_component<bench_component<9>>();
+    for (auto _ : state) {
+        for (auto const &e : entities)
+            registry.emplace_component<bench_component<9>>(e, 1.f);
+        registry.run_systems(0);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(event_churn_transient)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Components added in a random entity order, right away or recorded then played back sorted and batched.
+ */
+static void add_component_scattered(benchmark::State &state)
+{
+    ecs::registry registry;
+    auto const entities = shuffled(spawn(registry, static_cast<std::size_t>(state.range(0))));
+
+    registry.register_component<bench_component<0>>();
+    for (auto _ : state) {
+        for (auto const &e : entities)
+            registry.add_component<bench_component<0>>(e, { 1 });
+        state.PauseTiming();
+        registry.get_component<bench_component<0>>() = {};
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(add_component_scattered)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+static void add_component_deferred(benchmark::State &state)
+{
+    ecs::registry registry;
+    auto const entities = shuffled(spawn(registry, static_cast<std::size_t>(state.range(0))));
+
+    registry.register_component<bench_component<0>>();
+    for (auto _ : state) {
+        for (auto const &e : entities)
+            registry.commands().add(e, bench_component<0>{ 1 });
+        registry.flush_commands();
+        state.PauseTiming();
+        registry.get_component<bench_component<0>>() = {};
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(add_component_deferred)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
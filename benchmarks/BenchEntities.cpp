@@ -0,0 +1,57 @@
+#include <vector>
+#include <iterator>
+#include <registry.hpp>
+#include "Bench.hpp"
+
+static void spawn_entities(benchmark::State &state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        ecs::registry registry;
+
+        for (std::size_t i = 0; i < n; ++i)
+            benchmark::DoNotOptimize(registry.spawn_entity());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(spawn_entities)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+static void spawn_kill_entities(benchmark::State &state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    std::vector<ecs::entity> entities;
+
+    entities.reserve(n);
+    for (auto _ : state) {
+        ecs::registry registry;
+
+        registry.register_component<bench_component<0>>();
+        for (std::size_t i = 0; i < n; ++i)
+            entities.push_back(registry.spawn_entity());
+        for (auto const &e : entities)
+            registry.kill_entity(e);
+        entities.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(spawn_kill_entities)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+static void spawn_kill_entities_batch(benchmark::State &state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    std::vector<ecs::entity> entities;
+
+    entities.reserve(n);
+    for (auto _ : state) {
+        ecs::registry registry;
+
+        registry.register_component<bench_component<0>>();
+        registry.spawn_entities(n, std::back_inserter(entities));
+        registry.kill_entities(entities);
+        entities.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(spawn_kill_entities_batch)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
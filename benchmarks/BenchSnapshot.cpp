@@ -0,0 +1,87 @@
+#include <vector>
+#include <sstream>
+#include <iterator>
+#include <registry.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+    void populate(ecs::registry &registry, std::size_t n)
+    {
+        std::vector<ecs::entity> entities;
+
+        registry.register_component<bench_component<0>>();
+        registry.register_component<bench_component<1>>();
+        registry.spawn_entities(n, std::back_inserter(entities));
+        registry.emplace_n<bench_component<0>>(entities, 1.f);
+        registry.emplace_n<bench_component<1>>(entities, 2.f);
+    }
+}
+
+static void snapshot_save(benchmark::State &state)
+{
+    ecs::registry registry;
+
+    populate(registry, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::stringstream stream;
+
+        registry.save(stream);
+        benchmark::DoNotOptimize(stream);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(snapshot_save)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+static void snapshot_load(benchmark::State &state)
+{
+    ecs::registry source;
+    ecs::registry registry;
+    std::stringstream stream;
+
+    populate(source, static_cast<std::size_t>(state.range(0)));
+    source.save(stream);
+    registry.register_component<bench_component<0>>();
+    registry.register_component<bench_component<1>>();
+    for (auto _ : state) {
+        stream.seekg(0);
+        registry.load(stream);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(snapshot_load)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Restoring a copy of the registry by copy assignment, which allocates a new registry.
+ */
+static void registry_copy(benchmark::State &state)
+{
+    ecs::registry source;
+    ecs::registry registry;
+
+    populate(source, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        registry = source;
+        benchmark::DoNotOptimize(registry);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(registry_copy)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Restoring a copy of the registry in place, reusing the pages of the components.
+ */
+static void registry_copy_from(benchmark::State &state)
+{
+    ecs::registry source;
+    ecs::registry registry;
+
+    populate(source, static_cast<std::size_t>(state.range(0)));
+    registry.copy_from(source);
+    for (auto _ : state) {
+        registry.copy_from(source);
+        benchmark::DoNotOptimize(registry);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(registry_copy_from)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
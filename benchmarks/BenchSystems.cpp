@@ -0,0 +1,237 @@
+#include <utility>
+#include <registry.hpp>
+#include <zipper.hpp>
+#include <batch.hpp>
+#include "Bench.hpp"
+
+/**
+ * @brief Cost of dispatching systems that do no work, measured per system.
+ */
+static void run_systems_overhead(benchmark::State &state)
+{
+    ecs::registry registry;
+
+    registry.register_component<bench_component<0>>();
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        registry.add_system<bench_component<0>>([](ecs::registry &, double, auto &pool) {
+            benchmark::DoNotOptimize(pool);
+        });
+    for (auto _ : state)
+        registry.run_systems(0.016);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(run_systems_overhead)->Arg(1)->Arg(10)->Arg(100);
+
+/**
+ * @brief Two systems moving the entities, the first one only reads the speed.
+ */
+static void run_systems(benchmark::State &state)
+{
+    ecs::registry registry;
+    const auto n = static_cast<std::size_t>(state.range(0));
+
+    registry.register_component<bench_component<0>>();
+    registry.register_component<bench_component<1>>();
+    for (std::size_t i = 0; i < n; ++i) {
+        auto const e = registry.spawn_entity();
+
+        registry.emplace_component<bench_component<0>>(e, 0.f);
+        registry.emplace_component<bench_component<1>>(e, 1.f);
+    }
+    registry.add_system<bench_component<0>, bench_component<1> const>(
+        [](ecs::registry &, double deltaTime, auto &positions, auto const &speeds) {
+            for (auto &&[p, s] : ecs::containers::zipper(positions, speeds))
+                p.value += s.value * static_cast<float>(deltaTime);
+        });
+    registry.add_system<bench_component<1>>([](ecs::registry &, double, auto &speeds) {
+        for (auto &&[s] : ecs::containers::zipper(speeds))
+            s.value *= 0.99f;
+    });
+    for (auto _ : state)
+        registry.run_systems(0.016);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(run_systems)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+namespace
+{
+    struct bench_vector {
+        float x;
+        float y;
+        float z;
+    };
+
+    struct bench_position {
+        float x;
+        float y;
+        float z;
+    };
+
+    struct bench_velocity {
+        float x;
+        float y;
+        float z;
+    };
+
+    template<class Storage>
+    void fill(Storage &storage, std::size_t n, float value)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            storage.insert_at(i, typename Storage::component_type{ value, value, value });
+    }
+}
+
+template<>
+struct ecs::soa_fields<bench_position>
+{
+    static constexpr auto members = std::make_tuple(&bench_position::x, &bench_position::y, &bench_position::z);
+};
+
+template<>
+struct ecs::soa_fields<bench_velocity>
+{
+    static constexpr auto members = std::make_tuple(&bench_velocity::x, &bench_velocity::y, &bench_velocity::z);
+};
+
+/**
+ * @brief pos += vel * dt over components stored whole in sparse_arrays.
+ */
+static void integrate_sparse_array(benchmark::State &state)
+{
+    ecs::containers::sparse_array<bench_vector> positions;
+    ecs::containers::sparse_array<bench_vector> velocities;
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const float dt = 0.016f;
+
+    fill(positions, n, 0.f);
+    fill(velocities, n, 1.f);
+    for (auto _ : state) {
+        for (auto &&[p, v] : ecs::containers::zipper(positions, std::as_const(velocities))) {
+            p.x += v.x * dt;
+            p.y += v.y * dt;
+            p.z += v.z * dt;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(integrate_sparse_array)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief pos += vel * dt over components stored field by field, through the proxies handed out by the zipper.
+ */
+static void integrate_soa_array(benchmark::State &state)
+{
+    ecs::containers::soa_array<bench_position> positions;
+    ecs::containers::soa_array<bench_velocity> velocities;
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const float dt = 0.016f;
+
+    fill(positions, n, 0.f);
+    fill(velocities, n, 1.f);
+    for (auto _ : state) {
+        for (auto &&[p, v] : ecs::containers::zipper(positions, std::as_const(velocities))) {
+            p.get<0>() += v.get<0>() * dt;
+            p.get<1>() += v.get<1>() * dt;
+            p.get<2>() += v.get<2>() * dt;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(integrate_soa_array)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief pos += vel * dt over the columns of soa_arrays, a loop over plain arrays the compiler vectorizes. Every
+ * position of a page is updated, the entities own both components.
+ */
+static void integrate_soa_columns(benchmark::State &state)
+{
+    using positions_type = ecs::containers::soa_array<bench_position>;
+
+    positions_type positions;
+    ecs::containers::soa_array<bench_velocity> velocities;
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const float dt = 0.016f;
+
+    fill(positions, n, 0.f);
+    fill(velocities, n, 1.f);
+    for (auto _ : state) {
+        for (std::size_t page = 0; page < positions.pages(); ++page) {
+            float *__restrict px = positions.column<0>(page);
+            float *__restrict py = positions.column<1>(page);
+            float *__restrict pz = positions.column<2>(page);
+            float const *__restrict vx = std::as_const(velocities).column<0>(page);
+            float const *__restrict vy = std::as_const(velocities).column<1>(page);
+            float const *__restrict vz = std::as_const(velocities).column<2>(page);
+
+            for (std::size_t i = 0; i < positions_type::page_size; ++i) {
+                px[i] += vx[i] * dt;
+                py[i] += vy[i] * dt;
+                pz[i] += vz[i] * dt;
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(integrate_soa_columns)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief pos += vel * dt over the runs of components stored whole in sparse_arrays (see each_batch).
+ */
+static void integrate_sparse_array_batch(benchmark::State &state)
+{
+    ecs::containers::sparse_array<bench_vector> positions;
+    ecs::containers::sparse_array<bench_vector> velocities;
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const float dt = 0.016f;
+
+    fill(positions, n, 0.f);
+    fill(velocities, n, 1.f);
+    for (auto _ : state) {
+        ecs::containers::each_batch([dt](std::size_t, std::size_t count, auto p, auto v) {
+            for (std::size_t i = 0; i < count; ++i) {
+                p[i].x += v[i].x * dt;
+                p[i].y += v[i].y * dt;
+                p[i].z += v[i].z * dt;
+            }
+        }, positions, std::as_const(velocities));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(integrate_sparse_array_batch)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief pos += vel * dt over the runs of components stored field by field (see each_batch).
+ */
+static void integrate_soa_array_batch(benchmark::State &state)
+{
+    ecs::containers::soa_array<bench_position> positions;
+    ecs::containers::soa_array<bench_velocity> velocities;
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const float dt = 0.016f;
+
+    fill(positions, n, 0.f);
+    fill(velocities, n, 1.f);
+    for (auto _ : state) {
+        ecs::containers::each_batch([dt](std::size_t, std::size_t count, auto p, auto v) {
+            float *__restrict px = p.template get<0>().data();
+            float *__restrict py = p.template get<1>().data();
+            float *__restrict pz = p.template get<2>().data();
+            float const *__restrict vx = v.template get<0>().data();
+            float const *__restrict vy = v.template get<1>().data();
+            float const *__restrict vz = v.template get<2>().data();
+
+            for (std::size_t i = 0; i < count; ++i) {
+                px[i] += vx[i] * dt;
+                py[i] += vy[i] * dt;
+                pz[i] += vz[i] * dt;
+            }
+        }, positions, std::as_const(velocities));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(integrate_soa_array_batch)->Apply(entity_counts)->Unit(benchmark::kMillisecond);
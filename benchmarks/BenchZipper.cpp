@@ -0,0 +1,151 @@
+#include <utility>
+#include <registry.hpp>
+#include <zipper.hpp>
+#include <indexed_zipper.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+    /**
+     * @brief Registry holding Count components. Every entity owns the first component, the others are owned by the
+     * entities selected by the density.
+     */
+    template<std::size_t ... Is>
+    void populate(ecs::registry &registry, benchmark::State const &state, std::index_sequence<Is...>)
+    {
+        const auto n = static_cast<std::size_t>(state.range(0));
+
+        (registry.register_component<bench_component<Is>>(), ...);
+        for (std::size_t i = 0; i < n; ++i) {
+            auto const e = registry.spawn_entity();
+
+            ((Is == 0 || owns(i, state.range(1)) ?
+                (void) registry.emplace_component<bench_component<Is>>(e, 1.f) :
+                (void) 0), ...);
+        }
+    }
+
+    template<std::size_t ... Is>
+    void zip(benchmark::State &state, std::index_sequence<Is...> seq)
+    {
+        ecs::registry registry;
+
+        populate(registry, state, seq);
+        for (auto _ : state) {
+            float sum = 0;
+
+            for (auto &&components : ecs::containers::zipper(registry.get_component<bench_component<Is>>()...))
+                sum += std::apply([](auto &... c) { return (c.value + ...); }, components);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template<std::size_t ... Is>
+    void indexed_zip(benchmark::State &state, std::index_sequence<Is...> seq)
+    {
+        ecs::registry registry;
+
+        populate(registry, state, seq);
+        for (auto _ : state) {
+            std::size_t sum = 0;
+
+            for (auto &&components : ecs::containers::indexed_zipper(registry.get_component<bench_component<Is>>()...))
+                sum += std::get<0>(components);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template<std::size_t ... Is>
+    void group_each(benchmark::State &state, std::index_sequence<Is...> seq)
+    {
+        ecs::registry registry;
+
+        populate(registry, state, seq);
+
+        auto const &group = registry.group<bench_component<Is>...>();
+
+        for (auto _ : state) {
+            float sum = 0;
+
+            group.each([&sum](ecs::entity const &, auto &... c) { sum += (c.value + ...); });
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+template<std::size_t Count>
+static void zipper(benchmark::State &state)
+{
+    zip(state, std::make_index_sequence<Count>{});
+}
+BENCHMARK_TEMPLATE(zipper, 1)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(zipper, 2)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(zipper, 3)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(zipper, 4)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(zipper, 5)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+
+template<std::size_t Count>
+static void indexed_zipper(benchmark::State &state)
+{
+    indexed_zip(state, std::make_index_sequence<Count>{});
+}
+BENCHMARK_TEMPLATE(indexed_zipper, 1)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(indexed_zipper, 2)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(indexed_zipper, 3)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(indexed_zipper, 4)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(indexed_zipper, 5)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+
+template<std::size_t Count>
+static void group(benchmark::State &state)
+{
+    group_each(state, std::make_index_sequence<Count>{});
+}
+BENCHMARK_TEMPLATE(group, 1)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(group, 2)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(group, 3)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(group, 4)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(group, 5)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+
+static void zipper_exclude(benchmark::State &state)
+{
+    ecs::registry registry;
+
+    populate(registry, state, std::make_index_sequence<2>{});
+
+    auto &components = registry.get_component<bench_component<0>>();
+    auto const &excluded = registry.get_component<bench_component<1>>();
+
+    for (auto _ : state) {
+        float sum = 0;
+
+        for (auto &&[c] : ecs::containers::zipper(components, ecs::containers::exclude(excluded)))
+            sum += c.value;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(zipper_exclude)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
+
+static void zipper_probe_exclude(benchmark::State &state)
+{
+    ecs::registry registry;
+
+    populate(registry, state, std::make_index_sequence<2>{});
+
+    auto &components = registry.get_component<bench_component<0>>();
+    auto const &excluded = registry.get_component<bench_component<1>>();
+
+    for (auto _ : state) {
+        float sum = 0;
+
+        for (auto &&[index, c] : ecs::containers::indexed_zipper(components))
+            if (!excluded.contains(index))
+                sum += c.value;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(zipper_probe_exclude)->Apply(entity_counts_and_densities)->Unit(benchmark::kMillisecond);
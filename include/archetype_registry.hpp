@@ -0,0 +1,405 @@
+#ifndef ARCHETYPE_REGISTRY_HPP
+#define ARCHETYPE_REGISTRY_HPP
+
+#include <map>
+#include <tuple>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+
+#include "component_id.hpp"
+#include "entity.hpp"
+#include "entity_pool.hpp"
+
+namespace ecs
+{
+    /**
+     * @brief This class refers to a registry storing components by archetype. Entities owning the same set of
+     * components live in the same table, which stores every component in its own contiguous column: iterating over the
+     * entities owning a set of components walks the columns of the matching tables without checking whether each
+     * entity owns the components. Adding or removing a component moves the entity to the table of its new component
+     * set, which makes it more expensive than with the registry.
+     * @note The archetype_registry is an alternative to the registry, not a storage behind it: it has its own API
+     * (components need no registration, systems are passed views instead of containers) and none of the registry's
+     * signals, groups, snapshots, command buffers or concurrent systems.
+     * @warning References to components are invalidated when a component is added to or removed from any entity
+     * sharing their table, and when an entity of their table is killed.
+     */
+    class archetype_registry
+    {
+        public:
+            template <class ... Components>
+            class view;
+
+            archetype_registry();
+
+            archetype_registry(archetype_registry const &other);
+
+            archetype_registry(archetype_registry &&other) noexcept = default;
+
+            ~archetype_registry() = default;
+
+            archetype_registry &operator=(archetype_registry const &other);
+
+            archetype_registry &operator=(archetype_registry &&other) noexcept = default;
+
+            /**
+             * @brief This method creates an entity owning no component. When entity is about to get destroyed,
+             * kill_entity must be called.
+             * @return The created entity.
+             */
+            entity spawn_entity();
+
+            /**
+             * @brief This method created an entity from the given index.
+             * @param [in] index This parameter refers to the index to be used to create entity.
+             * @return The created entity.
+             * @throw May throw a runtime_error "entity already spawned." if the given index is an already spawned
+             * entity.
+             */
+            entity entity_from_index(std::size_t index);
+
+            /**
+             * @brief This methods kills the given entity and destroys its components. Does nothing if the entity is not
+             * alive.
+             * @param [in] e This parameter refers to the entity to kill.
+             */
+            void kill_entity(entity const &e) noexcept;
+
+            /**
+             * @brief This method checks whether an entity is alive.
+             * @param [in] e This parameter refers to the entity to check.
+             */
+            [[nodiscard]] bool valid(entity const &e) const noexcept;
+
+            /**
+             * @brief This method adds a component to the given entity. The entity moves to the table of its new
+             * component set, unless it already owns the component.
+             * @tparam Component This template refers to the component to add to the entity.
+             * @param [in] e This parameter refers to the entity to add the component to.
+             * @param [in] value This parameter refers to the value to assign to the component using move.
+             * @return A reference to the component contained in the table.
+             * @throw If the entity is not alive, the method throws an std::out_of_range.
+             */
+            template <typename Component>
+            Component &add_component(entity const &e, Component &&value)
+            {
+                return emplace_component<std::decay_t<Component>>(e, std::forward<Component>(value));
+            }
+
+            /**
+             * @brief This method constructs a component and adds it to the given entity. The entity moves to the table
+             * of its new component set, unless it already owns the component.
+             * @tparam Component This template refers to the component to emplace to the entity.
+             * @tparam Params This variadic template refers to the type of the parameters to pass to the component's
+             * constructor.
+             * @param [in] e This parameter refers to the entity to add the component to.
+             * @param [in] p This parameter refers to the value of the parameters to pass to the component's constructor.
+             * @return A reference to the component contained in the table.
+             * @throw If the entity is not alive, the method throws an std::out_of_range.
+             */
+            template <typename Component, typename ... Params>
+            Component &emplace_component(entity const &e, Params &&... p)
+            {
+                const std::size_t id = component_id::get<Component>();
+                const location from = _location(e);
+
+                if (auto *existing = _tables[from.table]->column(id))
+                    return (_data<Component>(*existing)[from.row] = Component(std::forward<Params>(p)...));
+
+                const std::size_t to = _table_with(from.table, id, &column<Component>::make);
+                auto &data = _data<Component>(*_tables[to]->column(id));
+
+                data.emplace_back(std::forward<Params>(p)...);
+                try {
+                    _move(e, to);
+                } catch (...) {
+                    data.pop_back();
+                    throw;
+                }
+                return (data.back());
+            }
+
+            /**
+             * @brief This method removes a component from an entity. The entity moves to the table of its new
+             * component set. Does nothing if the entity does not own the component.
+             * @tparam Component This template refers to the component to remove from the entity.
+             * @param [in] e This parameter refers to the entity to remove the component from.
+             * @throw If the entity is not alive, the method throws an std::out_of_range.
+             */
+            template <typename Component>
+            void remove_component(entity const &e)
+            {
+                const std::size_t id = component_id::get<Component>();
+                const location from = _location(e);
+
+                if (_tables[from.table]->column(id))
+                    _move(e, _table_without(from.table, id));
+            }
+
+            /**
+             * @brief This method checks whether an entity owns a component.
+             * @tparam Component This template refers to the component to look for.
+             * @param [in] e This parameter refers to the entity.
+             */
+            template <typename Component>
+            [[nodiscard]] bool has_component(entity const &e) const noexcept
+            {
+                return valid(e) && _tables[_locations[e.index()].table]->column(component_id::get<Component>());
+            }
+
+            /**
+             * @brief This method gets the component of an entity.
+             * @tparam Component This template refers to the component type to get.
+             * @param [in] e This parameter refers to the entity owning the component.
+             * @return A reference to the component contained in the table.
+             * @throw If the entity is not alive or does not own the component, the method throws an std::out_of_range.
+             */
+            template <typename Component>
+            [[nodiscard]] Component &get_component(entity const &e)
+            {
+                const location at = _location(e);
+                auto *c = _tables[at.table]->column(component_id::get<Component>());
+
+                if (!c)
+                    throw std::out_of_range("Component not found");
+                return (_data<Component>(*c)[at.row]);
+            }
+
+            /**
+             * @brief This method gets a view over the entities owning a set of components.
+             * @tparam Components This variadic template refers to the components to view. A const qualified component
+             * is passed to the functions as a const reference.
+             */
+            template <class ... Components>
+            [[nodiscard]] view<Components...> get_view();
+
+            /**
+             * @brief This method registers a system into the registry.
+             * @tparam Components This variadic template refers to the components to be used by the system. The system
+             * is called as f(registry, deltaTime, view<Components...>).
+             * @tparam Function This template refers to the type of the system (it MUST implement the () operator).
+             * @param [in] f This parameter refers to the system.
+             */
+            template <class ... Components, typename Function>
+            void add_system(Function &&f)
+            {
+                _systems.emplace_back([f = std::forward<Function>(f)](archetype_registry &r, double deltaTime) {
+                    f(r, deltaTime, r.get_view<Components...>());
+                });
+            }
+
+            /**
+             * @brief This method runs all systems registered into the registry, in the order they were added.
+             */
+            void run_systems(double deltaTime);
+
+        private:
+            static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+            /**
+             * @brief Type erased column of a table.
+             */
+            struct column_base
+            {
+                virtual ~column_base() = default;
+
+                [[nodiscard]] virtual std::unique_ptr<column_base> empty() const = 0;
+
+                [[nodiscard]] virtual std::unique_ptr<column_base> clone() const = 0;
+
+                /**
+                 * @brief Appends the component stored in a given row of another column of the same type, by moving it.
+                 */
+                virtual void push_from(column_base &other, std::size_t row) = 0;
+
+                virtual void pop_back() noexcept = 0;
+
+                /**
+                 * @brief Destroys the component stored in a given row, the last component is moved in its place.
+                 */
+                virtual void swap_remove(std::size_t row) noexcept = 0;
+            };
+
+            template <class Component>
+            struct column final : column_base
+            {
+                std::vector<Component> data{};
+
+                [[nodiscard]] static std::unique_ptr<column_base> make()
+                {
+                    return std::make_unique<column>();
+                }
+
+                [[nodiscard]] std::unique_ptr<column_base> empty() const override
+                {
+                    return make();
+                }
+
+                [[nodiscard]] std::unique_ptr<column_base> clone() const override
+                {
+                    return std::make_unique<column>(*this);
+                }
+
+                void push_from(column_base &other, std::size_t row) override
+                {
+                    data.push_back(std::move(static_cast<column &>(other).data[row]));
+                }
+
+                void pop_back() noexcept override
+                {
+                    data.pop_back();
+                }
+
+                void swap_remove(std::size_t row) noexcept override
+                {
+                    if (row + 1 != data.size())
+                        data[row] = std::move(data.back());
+                    data.pop_back();
+                }
+            };
+
+            using column_factory = std::unique_ptr<column_base> (*)();
+
+            /**
+             * @brief Entities owning the same set of components, and the edges leading to the tables of the sets
+             * with one more or one less component.
+             */
+            struct table
+            {
+                std::vector<std::size_t> type{};
+
+                std::vector<std::size_t> columnOf{};
+
+                std::vector<std::unique_ptr<column_base>> columns{};
+
+                std::vector<entity> entities{};
+
+                std::unordered_map<std::size_t, std::size_t> addEdges{};
+
+                std::unordered_map<std::size_t, std::size_t> removeEdges{};
+
+                /**
+                 * @brief Returns the column storing a component, or nullptr if the table does not store it.
+                 */
+                [[nodiscard]] column_base *column(std::size_t id) const noexcept
+                {
+                    return id < columnOf.size() && columnOf[id] != npos ? columns[columnOf[id]].get() : nullptr;
+                }
+            };
+
+            struct location
+            {
+                std::size_t table;
+
+                std::size_t row;
+            };
+
+            std::vector<std::unique_ptr<table>> _tables;
+
+            std::map<std::vector<std::size_t>, std::size_t> _tableIndex;
+
+            std::vector<location> _locations;
+
+            std::vector<std::function<void (archetype_registry &r, double deltaTime)>> _systems;
+
+            entity_pool _entities;
+
+            template <class Component>
+            [[nodiscard]] static std::vector<Component> &_data(column_base &c) noexcept
+            {
+                return static_cast<column<Component> &>(c).data;
+            }
+
+            [[nodiscard]] location _location(entity const &e) const;
+
+            void _place(entity const &e);
+
+            void _move(entity const &e, std::size_t to);
+
+            void _remove_row(std::size_t t, std::size_t row) noexcept;
+
+            [[nodiscard]] std::size_t _table_with(std::size_t from, std::size_t id, column_factory make);
+
+            [[nodiscard]] std::size_t _table_without(std::size_t from, std::size_t id);
+
+            [[nodiscard]] std::size_t _table(
+                std::vector<std::size_t> const &type,
+                table const &from,
+                std::size_t id,
+                column_factory make);
+    };
+
+    /**
+     * @brief This class refers to the entities owning a set of components, grouped by table. The tables are selected
+     * when the view is built.
+     * @tparam Components This variadic template refers to the components to view.
+     */
+    template <class ... Components>
+    class archetype_registry::view
+    {
+        public:
+            /**
+             * @brief This method calls a function for every entity owning ALL components, table by table.
+             * @tparam Function This template refers to the type of the function, called as f(components...).
+             * @param [in] f This parameter refers to the function to call.
+             */
+            template <class Function>
+            void each(Function &&f) const
+            {
+                for (auto *t : _tables)
+                    _each(*t, f, std::index_sequence_for<Components...>{});
+            }
+
+            /**
+             * @brief This method returns the number of entities owning ALL components.
+             */
+            [[nodiscard]] std::size_t size() const noexcept
+            {
+                std::size_t size = 0;
+
+                for (auto const *t : _tables)
+                    size += t->entities.size();
+                return (size);
+            }
+
+        private:
+            friend archetype_registry;
+
+            std::vector<table *> _tables;
+
+            explicit view(std::vector<table *> tables) noexcept :
+                _tables(std::move(tables))
+            {}
+
+            template <class Function, std::size_t ... Is>
+            static void _each(table &t, Function &f, std::index_sequence<Is ...>)
+            {
+                const std::tuple<Components *...> columns(
+                    _data<std::remove_const_t<Components>>(*t.column(component_id::get<Components>())).data()...
+                );
+                const std::size_t rows = t.entities.size();
+
+                for (std::size_t row = 0; row < rows; ++row)
+                    f(std::get<Is>(columns)[row]...);
+            }
+    };
+
+    template <class ... Components>
+    archetype_registry::view<Components...> archetype_registry::get_view()
+    {
+        std::vector<table *> tables;
+
+        for (auto const &t : _tables)
+            if ((t->column(component_id::get<Components>()) && ...))
+                tables.push_back(t.get());
+        return view<Components...>(std::move(tables));
+    }
+}
+
+#endif //ARCHETYPE_REGISTRY_HPP
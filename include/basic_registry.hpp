@@ -0,0 +1,335 @@
+#ifndef BASIC_REGISTRY_HPP
+#define BASIC_REGISTRY_HPP
+
+#include <tuple>
+#include <iterator>
+#include <vector>
+#include <functional>
+#include <utility>
+#include <type_traits>
+#include <memory_resource>
+
+#include "component_storage.hpp"
+#include "entity.hpp"
+#include "entity_pool.hpp"
+#include "is_transient_set.hpp"
+#include "exceptions/invalid_entity_exception.hpp"
+
+namespace ecs
+{
+    /**
+     * @brief This class refers to a registry knowing its full component set at compile time. Pools are stored in a
+     * tuple: accessing the pool of a component resolves to a constant offset, can't fail at runtime and using a
+     * component outside of the set is a compile error.
+     * @tparam Components This variadic template refers to the components handled by the registry.
+     */
+    template<class ... Components>
+    class basic_registry
+    {
+        template<class Component, class ... Others>
+        static constexpr bool _count_v = (std::is_same_v<Component, Others> + ... + 0);
+
+        static_assert(((_count_v<Components, Components...> == 1) && ...), "Components must be unique.");
+
+        template<class Component>
+        static constexpr bool _contains_v = _count_v<std::remove_cv_t<Component>, Components...> == 1;
+
+        public:
+            basic_registry() :
+                _pools{},
+                _systems{},
+                _entities{}
+            {}
+
+            /**
+             * @brief This constructor creates a registry whose component pools allocate from a memory resource. Only
+             * the components stored in a container allocating from a memory resource use it (see ecs::pmr). The entity
+             * slots and the systems are always allocated from the heap.
+             * @param [in] resource This parameter refers to the memory resource, it must outlive the registry.
+             */
+            explicit basic_registry(std::pmr::memory_resource *resource) :
+                _pools(make_storage<component_storage_t<Components>>(resource)...),
+                _systems{},
+                _entities{}
+            {}
+
+            /**
+             * @brief This method creates an entity. When entity is about to get destroyed,
+             * kill_entity must be called.
+             * @return The created entity.
+             */
+            entity spawn_entity()
+            {
+                return _entities.spawn();
+            }
+
+            /**
+             * @brief This method creates several entities at once. When entities are about to get destroyed,
+             * kill_entity or kill_entities must be called.
+             * @tparam OutputIt This template refers to the type of the iterator receiving the entities.
+             * @param [in] n This parameter refers to the number of entities to create.
+             * @param [out] out This parameter refers to the iterator receiving the created entities.
+             * @return The iterator following the last entity written.
+             */
+            template <class OutputIt>
+            OutputIt spawn_entities(std::size_t n, OutputIt out)
+            {
+                return _entities.spawn_n(n, out);
+            }
+
+            /**
+             * @brief This method created an entity from the given index.
+             * @param [in] index This parameter refers to the index to be used to create entity.
+             * @return The created entity.
+             * @throw May throw a runtime_error "entity already spawned." if the given index is an already spawned
+             * entity.
+             */
+            entity entity_from_index(std::size_t index)
+            {
+                return _entities.spawn_at(index);
+            }
+
+            /**
+             * @brief This method creates an entity for every index of a range, for instance to mirror a block of
+             * replicated entities. Either all entities are created or none.
+             * @tparam OutputIt This template refers to the type of the iterator receiving the entities.
+             * @param [in] first This parameter refers to the first index to be used to create entities.
+             * @param [in] last This parameter refers to the index following the last index to be used.
+             * @param [out] out This parameter refers to the iterator receiving the created entities, in index order.
+             * @return The iterator following the last entity written.
+             * @throw May throw a runtime_error "entity already spawned." if an index of the range is an already spawned
+             * entity.
+             */
+            template <class OutputIt>
+            OutputIt entities_from_range(std::size_t first, std::size_t last, OutputIt out)
+            {
+                return _entities.spawn_range(first, last, out);
+            }
+
+            /**
+             * @brief This methods kills the given entity and removes all its components. Does nothing if the entity is
+             * not alive.
+             * @param [in] e This parameter refers to the entity to kill.
+             */
+            void kill_entity(entity const &e) noexcept
+            {
+                if (_entities.kill(e))
+                    (std::get<component_storage_t<Components>>(_pools).erase(e), ...);
+            }
+
+            /**
+             * @brief This methods kills several entities. Their components are removed in a single pass over each
+             * pool. Entities that are not alive are ignored.
+             * @tparam Entities This template refers to the type of the range of entities, it must be a forward range.
+             * @param [in] entities This parameter refers to the entities to kill.
+             */
+            template <class Entities>
+            void kill_entities(Entities const &entities)
+            {
+                std::vector<entity> killed;
+
+                killed.reserve(static_cast<std::size_t>(std::distance(std::begin(entities), std::end(entities))));
+                for (auto const &e : entities)
+                    if (_entities.kill(e))
+                        killed.push_back(e);
+                ([&killed](auto &pool) {
+                    for (auto const &e : killed)
+                        pool.erase(e);
+                }(std::get<component_storage_t<Components>>(_pools)), ...);
+            }
+
+            /**
+             * @brief This method checks whether an entity is alive.
+             * @param [in] e This parameter refers to the entity to check.
+             */
+            [[nodiscard]] bool valid(entity const &e) const noexcept
+            {
+                return _entities.valid(e);
+            }
+
+            /**
+             * @brief This method adds a component to the given entity.
+             * @tparam Component This template refers to the component to add to the entity.
+             * @param [in] entity This parameter refers to the entity to add the component to.
+             * @param [in] value This parameter refers to the value to assign to the component using move.
+             * @return A reference to the component contained in the pool.
+             * @throw If the entity is not alive, the method throws an invalid_entity_exception.
+             */
+            template <typename Component>
+            typename component_storage_t<Component>::reference_type add_component(
+                entity const &entity,
+                Component &&value)
+            {
+                _entities.check(entity);
+                return get_component<Component>().insert_at(entity, std::forward<Component>(value));
+            }
+
+            /**
+             * @brief This method constructs a component and adds it to the given entity.
+             * @tparam Component This template refers to the component to emplace to the entity.
+             * @tparam Params This variadic template refers to the type of the parameters to pass to the component's
+             * constructor.
+             * @param [in] entity This parameter refers to the entity to add the component to.
+             * @param [in] p This parameter refers to the value of the parameters to pass to the component's constructor.
+             * @return A reference to the component contained in the pool.
+             * @throw If the entity is not alive, the method throws an invalid_entity_exception.
+             */
+            template <typename Component, typename ... Params>
+            typename component_storage_t<Component>::reference_type emplace_component(
+                entity const &entity,
+                Params &&... p)
+            {
+                _entities.check(entity);
+                return get_component<Component>().emplace_at(entity, std::forward<Params>(p)...);
+            }
+
+            /**
+             * @brief This method adds a component to several entities. The pool is grown once for all the entities.
+             * @tparam Component This template refers to the component to add to the entities.
+             * @tparam Entities This template refers to the type of the range of entities, it must be a forward range.
+             * @tparam Values This template refers to the type of the range of values.
+             * @param [in] entities This parameter refers to the entities to add the component to.
+             * @param [in] values This parameter refers to the values to assign to the components, one per entity. The
+             * values are moved if the range is an rvalue.
+             * @throw If an entity is not alive, the method throws an invalid_entity_exception and no component is
+             * added.
+             */
+            template <typename Component, class Entities, class Values>
+            void insert_range(Entities const &entities, Values &&values)
+            {
+                auto &pool = get_component<Component>();
+
+                for (auto const &e : entities)
+                    _entities.check(e);
+                if constexpr (std::is_rvalue_reference_v<Values &&>)
+                    pool.insert_range(
+                        std::begin(entities),
+                        std::end(entities),
+                        std::make_move_iterator(std::begin(values))
+                    );
+                else
+                    pool.insert_range(std::begin(entities), std::end(entities), std::begin(values));
+            }
+
+            /**
+             * @brief This method constructs a component for several entities from the same parameters. The pool is
+             * grown once for all the entities.
+             * @tparam Component This template refers to the component to emplace to the entities.
+             * @tparam Entities This template refers to the type of the range of entities, it must be a forward range.
+             * @tparam Params This variadic template refers to the type of the parameters to pass to the component's
+             * constructor.
+             * @param [in] entities This parameter refers to the entities to add the component to.
+             * @param [in] p This parameter refers to the parameters to pass to every constructor.
+             * @throw If an entity is not alive, the method throws an invalid_entity_exception and no component is
+             * added.
+             */
+            template <typename Component, class Entities, typename ... Params>
+            void emplace_n(Entities const &entities, Params const &... p)
+            {
+                for (auto const &e : entities)
+                    _entities.check(e);
+                get_component<Component>().emplace_n(std::begin(entities), std::end(entities), p...);
+            }
+
+            /**
+             * @brief This method removes a component from an entity. Does nothing if the entity is not alive, its
+             * components were removed when it was killed.
+             * @tparam Component This template refers to the component to remove from the entity.
+             * @param [in] entity This parameter refers to the entity to remove the component from.
+             */
+            template <typename Component>
+            void remove_component(entity const &entity)
+            {
+                if (_entities.valid(entity))
+                    get_component<Component>().erase(entity);
+            }
+
+            /**
+             * @brief This method gets the pool of a given component.
+             * @tparam Component This template refers to the component type to get.
+             * @return A reference to the pool of Component.
+             */
+            template <class Component>
+            [[nodiscard]] component_storage_t<Component> &get_component() noexcept
+            {
+                static_assert(_contains_v<Component>, "Component is not part of the registry.");
+                return std::get<component_storage_t<Component>>(_pools);
+            }
+
+            /**
+             * @brief This method gets the pool of a given component.
+             * @tparam Component This template refers to the component type to get.
+             * @return A constant reference to the pool of Component.
+             */
+            template <class Component>
+            [[nodiscard]] component_storage_t<Component> const &get_component() const noexcept
+            {
+                static_assert(_contains_v<Component>, "Component is not part of the registry.");
+                return std::get<component_storage_t<Component>>(_pools);
+            }
+
+            /**
+             * @brief This method registers a system into the registry.
+             * @tparam SystemComponents This variadic template refers to the components to be used by the system. A
+             * const qualified component is passed to the system as a const reference.
+             * @tparam Function This template refers to the type of the system (it MUST implement the () operator).
+             * @param [in] f This parameter refers to the system.
+             */
+            template <class ... SystemComponents, typename Function>
+            void add_system(Function &&f)
+            {
+                static_assert((_contains_v<SystemComponents> && ...), "Components are not part of the registry.");
+                _systems.emplace_back([f = std::forward<Function>(f)](basic_registry &r, double deltaTime) {
+                    f(r, deltaTime, r.template _system_argument<SystemComponents>()...);
+                });
+            }
+
+            /**
+             * @brief This method runs a system right away, without storing it. The system is called directly, so the
+             * compiler can inline its body at the call site.
+             * @tparam SystemComponents This variadic template refers to the components to be used by the system. A
+             * const qualified component is passed to the system as a const reference.
+             * @tparam Function This template refers to the type of the system (it MUST implement the () operator).
+             * @param [in] deltaTime This parameter refers to the time elapsed since the last run.
+             * @param [in] f This parameter refers to the system.
+             */
+            template <class ... SystemComponents, typename Function>
+            void run_system(double deltaTime, Function &&f)
+            {
+                static_assert((_contains_v<SystemComponents> && ...), "Components are not part of the registry.");
+                std::forward<Function>(f)(*this, deltaTime, _system_argument<SystemComponents>()...);
+            }
+
+            /**
+             * @brief This method runs all systems registered into the registry. Once every system has run, the
+             * components stored in a transient_set are cleared.
+             */
+            void run_systems(double deltaTime)
+            {
+                for (auto const &system : _systems)
+                    system(*this, deltaTime);
+                ([](auto &pool) {
+                    if constexpr (assertion::is_transient_set_v<std::remove_reference_t<decltype(pool)>>)
+                        pool.clear();
+                }(std::get<component_storage_t<Components>>(_pools)), ...);
+            }
+
+        private:
+            std::tuple<component_storage_t<Components>...> _pools;
+
+            std::vector<std::function<void (basic_registry &r, double deltaTime)>> _systems;
+
+            entity_pool _entities;
+
+            template <class Component>
+            [[nodiscard]] auto &_system_argument() noexcept
+            {
+                if constexpr (std::is_const_v<Component>)
+                    return std::as_const(*this).template get_component<std::remove_const_t<Component>>();
+                else
+                    return get_component<Component>();
+            }
+    };
+}
+
+#endif //BASIC_REGISTRY_HPP
@@ -0,0 +1,80 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#include "bitset.hpp"
+#include "is_soa_array.hpp"
+
+namespace ecs::containers
+{
+    /**
+     * @brief This function calls a function for every run of consecutive positions storing a component in all the
+     * given containers, instead of once per position as the zippers do. The runs are found by intersecting the
+     * presence bitsets a word at a time, and are cut at the page boundaries so that the components of a run lie in a
+     * single page: the function is passed a view over them per container (see sparse_array::components and
+     * soa_array::components). Only the views of a soa_array are plain arrays, of each field, that a loop walks
+     * contiguously and the compiler vectorizes. The view of a sparse_array walks its std::optional slots, strided by
+     * the size of a slot: batching it only saves the per-entity presence checks of the zippers.
+     * @code
+     * ecs::containers::each_batch([dt](std::size_t, std::size_t count, auto positions, auto velocities) {
+     *     auto x = positions.template get<0>();
+     *     auto vx = velocities.template get<0>();
+     *
+     *     for (std::size_t i = 0; i < count; ++i)
+     *         x[i] += vx[i] * dt;
+     * }, positions, std::as_const(velocities));
+     * @endcode
+     * @tparam Function This template refers to the type of the function, called as f(first, count, views...) where
+     * first is the first position of the run and count its length.
+     * @tparam Containers This variadic template refers to the containers (sparse_array or soa_array), a const
+     * container gives read-only views.
+     * @param [in] f This parameter refers to the function to call.
+     * @param [in] containers This parameter refers to the containers.
+     */
+    template<class Function, class ... Containers>
+    void each_batch(Function &&f, Containers &...containers)
+    {
+        static_assert(sizeof...(Containers) > 0, "At least one container is required.");
+        static_assert(
+            (assertion::has_presence_v<Containers> && ...),
+            "Containers must be sparse_array or soa_array."
+        );
+
+        constexpr std::size_t pageSize = (std::min)({ std::remove_const_t<Containers>::page_size... });
+        const std::size_t size = (std::min)({ containers.size()... });
+        const std::size_t words = (size + bitset::word_bits - 1) / bitset::word_bits;
+        std::size_t first = 0;
+        std::size_t count = 0;
+        auto const flush = [&]() {
+            if (count > 0)
+                f(first, count, containers.components(first, count)...);
+            count = 0;
+        };
+
+        for (std::size_t w = 0; w < words; ++w) {
+            bitset::word_type word = (containers.presence()[w] & ...);
+            const std::size_t base = w * bitset::word_bits;
+
+            if (base % pageSize == 0)
+                flush();
+            while (word != 0) {
+                const std::size_t start = bitset::lowest_bit(word);
+                const bitset::word_type rest = ~(word >> start);
+                const std::size_t length = rest == 0 ? bitset::word_bits - start : bitset::lowest_bit(rest);
+
+                if (count == 0 || first + count != base + start) {
+                    flush();
+                    first = base + start;
+                }
+                count += length;
+                word = start + length == bitset::word_bits ? 0 : word & (~bitset::word_type{0} << (start + length));
+            }
+        }
+        flush();
+    }
+}
+
+#endif //BATCH_HPP
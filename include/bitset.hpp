@@ -0,0 +1,147 @@
+#ifndef BITSET_HPP
+#define BITSET_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ecs::bitset
+{
+    using word_type = std::uint64_t;
+
+    /**
+     * @brief Number of bits stored in a word.
+     */
+    static constexpr std::size_t word_bits = 64;
+
+    /**
+     * @brief This function returns the position of the lowest bit set in a word.
+     * @param [in] word This parameter refers to the word to search, it must not be 0.
+     */
+    [[nodiscard]] inline std::size_t lowest_bit(word_type word) noexcept
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+
+        _BitScanForward64(&index, word);
+        return (index);
+#else
+        return (static_cast<std::size_t>(__builtin_ctzll(word)));
+#endif
+    }
+
+#if defined(__AVX2__)
+    [[nodiscard]] inline __m256i _load(word_type const *words) noexcept
+    {
+        return (_mm256_loadu_si256(reinterpret_cast<__m256i const *>(words)));
+    }
+#endif
+
+    /**
+     * @brief This function returns the word of a position intersected over the bitsets, without the bits set in the
+     * excluded bitsets. An excluded bitset holding fewer words excludes nothing past its end.
+     */
+    template<std::size_t N, std::size_t M>
+    [[nodiscard]] inline word_type _word(
+        std::array<word_type const *, N> const &bitsets,
+        std::array<word_type const *, M> const &excluded,
+        std::array<std::size_t, M> const &excludedWords,
+        std::size_t w) noexcept
+    {
+        word_type word = bitsets[0][w];
+
+        for (std::size_t i = 1; i < N; ++i)
+            word &= bitsets[i][w];
+        for (std::size_t i = 0; i < M; ++i)
+            if (w < excludedWords[i])
+                word &= ~excluded[i][w];
+        return (word);
+    }
+
+    /**
+     * @brief This function returns the first position of a range whose bit is set in every bitset and in none of the
+     * excluded bitsets. Bitsets are intersected 256 bits at a time with AVX2 when the code is compiled with AVX2
+     * support (see SIMD_ENABLE), one word at a time otherwise.
+     * @tparam N This template refers to the number of bitsets to intersect.
+     * @tparam M This template refers to the number of excluded bitsets.
+     * @param [in] bitsets This parameter refers to the words of the bitsets. Every bitset must hold the words covering
+     * the range.
+     * @param [in] excluded This parameter refers to the words of the excluded bitsets.
+     * @param [in] excludedWords This parameter refers to the number of words of each excluded bitset, positions past
+     * them are not excluded.
+     * @param [in] first This parameter refers to the beginning of the range.
+     * @param [in] last This parameter refers to the end of the range.
+     * @return The position of the first bit matching, or last if there is none.
+     */
+    template<std::size_t N, std::size_t M>
+    [[nodiscard]] std::size_t find_first(
+        std::array<word_type const *, N> const &bitsets,
+        std::array<word_type const *, M> const &excluded,
+        std::array<std::size_t, M> const &excludedWords,
+        std::size_t first,
+        std::size_t last) noexcept
+    {
+        static_assert(N > 0, "At least one bitset is required.");
+
+        if (first >= last)
+            return (last);
+
+        const std::size_t lastWord = (last - 1) / word_bits + 1;
+        std::size_t w = first / word_bits;
+        word_type word = (~word_type{0} << (first % word_bits)) & _word(bitsets, excluded, excludedWords, w);
+
+        while (word == 0) {
+            ++w;
+#if defined(__AVX2__)
+            std::size_t blockEnd = lastWord;
+
+            for (std::size_t i = 0; i < M; ++i)
+                blockEnd = excludedWords[i] < blockEnd ? excludedWords[i] : blockEnd;
+            for (; w + 4 <= blockEnd; w += 4) {
+                __m256i block = _load(bitsets[0] + w);
+
+                for (std::size_t i = 1; i < N; ++i)
+                    block = _mm256_and_si256(block, _load(bitsets[i] + w));
+                for (std::size_t i = 0; i < M; ++i)
+                    block = _mm256_andnot_si256(_load(excluded[i] + w), block);
+                if (!_mm256_testz_si256(block, block))
+                    break;
+            }
+#endif
+            if (w >= lastWord)
+                return (last);
+            word = _word(bitsets, excluded, excludedWords, w);
+        }
+
+        const std::size_t pos = w * word_bits + lowest_bit(word);
+
+        return (pos < last ? pos : last);
+    }
+
+    /**
+     * @brief This function returns the first position of a range whose bit is set in every bitset (see the
+     * overload taking excluded bitsets).
+     * @tparam N This template refers to the number of bitsets to intersect.
+     * @param [in] bitsets This parameter refers to the words of the bitsets. Every bitset must hold the words covering
+     * the range.
+     * @param [in] first This parameter refers to the beginning of the range.
+     * @param [in] last This parameter refers to the end of the range.
+     * @return The position of the first bit set in every bitset, or last if there is none.
+     */
+    template<std::size_t N>
+    [[nodiscard]] std::size_t find_first(
+        std::array<word_type const *, N> const &bitsets,
+        std::size_t first,
+        std::size_t last) noexcept
+    {
+        return (find_first<N, 0>(bitsets, {}, {}, first, last));
+    }
+}
+
+#endif //BITSET_HPP
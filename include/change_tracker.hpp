@@ -0,0 +1,257 @@
+#ifndef CHANGE_TRACKER_HPP
+#define CHANGE_TRACKER_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "page_table.hpp"
+
+namespace ecs::containers
+{
+    /**
+     * @brief This class refers to the change tracking of a paged container. Every position holds the tick it was
+     * added at and the tick it was last changed at, in pages allocated along the pages of the container. Every page
+     * also holds the tick of its last change so unchanged pages are skipped, and removals are logged in tick order.
+     * Ticks are set by the owner of the container (see registry::tick), positions touched during a tick are stamped
+     * with it. Tracking is disabled by default: stamping costs memory bandwidth on every write, and the removal log
+     * grows until it is discarded.
+     * @note The stamps of a page are allocated with the page of the container (see allocate) rather than when a
+     * position is first changed: changed() only stores to the stamps of a component, so components changed by
+     * different threads (see zipper::par_each) are stamped without synchronization.
+     * @tparam PageSize This template refers to the number of positions of a page.
+     * @tparam Allocator This template refers to the allocator, rebound to allocate the stamps and the log.
+     */
+    template<std::size_t PageSize, class Allocator>
+    class change_tracker
+    {
+        public:
+            using tick_type = std::uint64_t;
+
+            using size_type = std::size_t;
+
+            explicit change_tracker(Allocator const &allocator) :
+                _enabled(false),
+                _tick(0),
+                _allChanged(0),
+                _stamps(allocator),
+                _pageChanged(tick_allocator(allocator)),
+                _removed(removal_allocator(allocator))
+            {}
+
+            change_tracker(change_tracker const &other, Allocator const &allocator) :
+                _enabled(other._enabled),
+                _tick(other._tick),
+                _allChanged(other._allChanged),
+                _stamps(other._stamps, allocator),
+                _pageChanged(other._pageChanged, tick_allocator(allocator)),
+                _removed(other._removed, removal_allocator(allocator))
+            {}
+
+            /**
+             * @brief This method checks whether the tracking is enabled. Nothing is stamped nor logged otherwise.
+             */
+            [[nodiscard]] bool enabled() const noexcept
+            {
+                return _enabled;
+            }
+
+            /**
+             * @brief This method enables or disables the tracking. Disabling it forgets the logged removals. Once
+             * enabled, the stamps of the pages already allocated by the container must be allocated (see allocate).
+             */
+            void enable(bool enabled)
+            {
+                _enabled = enabled;
+                if (!enabled)
+                    _removed.clear();
+            }
+
+            /**
+             * @brief This method returns the tick stamped on the positions touched.
+             */
+            [[nodiscard]] tick_type tick() const noexcept
+            {
+                return _tick;
+            }
+
+            void set_tick(tick_type tick) noexcept
+            {
+                _tick = tick;
+            }
+
+            /**
+             * @brief This method grows the stamps to cover a given number of pages. Stamps are not allocated.
+             */
+            void cover(size_type pages)
+            {
+                if (pages <= _pageChanged.size())
+                    return;
+                _pageChanged.resize(pages);
+                _stamps.resize(pages);
+            }
+
+            /**
+             * @brief This method allocates the stamps of a page covered, when the tracking is enabled. The container
+             * calls it whenever it allocates a page, and for each page allocated when the tracking is enabled.
+             */
+            void allocate(size_type page)
+            {
+                if (_enabled)
+                    _stamps.allocate(page);
+            }
+
+            void added(size_type pos)
+            {
+                if (!_enabled)
+                    return;
+
+                auto &s = _stamp(pos);
+
+                s.added = _tick;
+                s.changed = _tick;
+                _pageChanged[pos / PageSize].stamp(_tick);
+            }
+
+            /**
+             * @brief This method stamps a position as changed. It may be called concurrently for distinct positions,
+             * the stamps of the page must be allocated.
+             */
+            void changed(size_type pos)
+            {
+                if (!_enabled)
+                    return;
+
+                _stamp(pos).changed = _tick;
+                _pageChanged[pos / PageSize].stamp(_tick);
+            }
+
+            /**
+             * @brief This method marks every position as changed, for accesses that can't be tracked one by one.
+             */
+            void changed_all() noexcept
+            {
+                _allChanged = _tick;
+            }
+
+            void removed(size_type pos)
+            {
+                if (_enabled)
+                    _removed.emplace_back(pos, _tick);
+            }
+
+            [[nodiscard]] bool added_since(size_type pos, tick_type since) const noexcept
+            {
+                auto const *page = _stamps[pos / PageSize];
+
+                return page && (*page)[pos % PageSize].added >= since;
+            }
+
+            [[nodiscard]] bool changed_since(size_type pos, tick_type since) const noexcept
+            {
+                auto const *page = _stamps[pos / PageSize];
+
+                return _allChanged >= since || (page && (*page)[pos % PageSize].changed >= since);
+            }
+
+            [[nodiscard]] bool page_changed_since(size_type page, tick_type since) const noexcept
+            {
+                return _allChanged >= since || _pageChanged[page].load() >= since;
+            }
+
+            /**
+             * @brief This method calls a function for every position removed since a given tick, in removal order.
+             */
+            template<class Function>
+            void each_removed(tick_type since, Function &&f) const
+            {
+                for (auto it = _first_removed(since); it != _removed.end(); ++it)
+                    f(it->first);
+            }
+
+            /**
+             * @brief This method forgets the removals logged before a given tick.
+             */
+            void discard(tick_type until)
+            {
+                _removed.erase(_removed.begin(), _first_removed(until));
+            }
+
+        private:
+            /**
+             * @brief Tick of the last change of a page, stored atomically since the components of a page may be
+             * changed by several threads at once. Copied along the tracker.
+             */
+            struct page_tick
+            {
+                std::atomic<tick_type> value;
+
+                page_tick() noexcept :
+                    value(0)
+                {}
+
+                page_tick(page_tick const &other) noexcept :
+                    value(other.load())
+                {}
+
+                page_tick &operator=(page_tick const &other) noexcept
+                {
+                    value.store(other.load(), std::memory_order_relaxed);
+                    return *this;
+                }
+
+                [[nodiscard]] tick_type load() const noexcept
+                {
+                    return value.load(std::memory_order_relaxed);
+                }
+
+                void stamp(tick_type tick) noexcept
+                {
+                    if (load() != tick)
+                        value.store(tick, std::memory_order_relaxed);
+                }
+            };
+
+            using tick_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<page_tick>;
+
+            struct stamp
+            {
+                tick_type added;
+
+                tick_type changed;
+            };
+
+            using removal_type = std::pair<size_type, tick_type>;
+
+            using removal_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<removal_type>;
+
+            bool _enabled;
+
+            tick_type _tick;
+
+            tick_type _allChanged;
+
+            page_table<stamp, PageSize, Allocator> _stamps;
+
+            std::vector<page_tick, tick_allocator> _pageChanged;
+
+            std::vector<removal_type, removal_allocator> _removed;
+
+            [[nodiscard]] stamp &_stamp(size_type pos)
+            {
+                return (*_stamps[pos / PageSize])[pos % PageSize];
+            }
+
+            [[nodiscard]] auto _first_removed(tick_type since) const noexcept
+            {
+                return std::partition_point(_removed.begin(), _removed.end(), [since](removal_type const &r) {
+                    return r.second < since;
+                });
+            }
+    };
+}
+
+#endif //CHANGE_TRACKER_HPP
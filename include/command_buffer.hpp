@@ -0,0 +1,206 @@
+#ifndef COMMAND_BUFFER_HPP
+#define COMMAND_BUFFER_HPP
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <type_traits>
+
+#include "entity.hpp"
+#include "component_id.hpp"
+
+namespace ecs
+{
+    class registry;
+
+    /**
+     * @brief This class refers to a list of structural changes (components added and removed, entities killed)
+     * recorded to be applied later, for instance by a system that must not modify the pools it is iterating over.
+     * Recording a command only appends it to the buffer, with the commands targeting the same block of entity indexes.
+     * The commands are played back component by component and block by block, in index order, and the components
+     * added to a block are inserted with a single insert_range: scattered insertions touch each page of the pools
+     * once instead of in recording order.
+     * @note A command buffer is not thread-safe, the registry owns one per thread running systems (see
+     * registry::commands).
+     */
+    class command_buffer
+    {
+        public:
+            command_buffer() noexcept;
+
+            /**
+             * @brief This constructor creates an empty buffer, the commands of other are not copied: they refer to
+             * the registry other belongs to.
+             */
+            command_buffer(command_buffer const &other) noexcept;
+
+            command_buffer(command_buffer &&other) noexcept = default;
+
+            ~command_buffer() = default;
+
+            command_buffer &operator=(command_buffer const &other) = delete;
+
+            command_buffer &operator=(command_buffer &&other) noexcept = default;
+
+            /**
+             * @brief This method records the addition of a component to an entity, played back as add_component.
+             * @tparam Component This template refers to the type of the component.
+             * @param [in] e This parameter refers to the entity to add the component to.
+             * @param [in] value This parameter refers to the value of the component, moved if it is an rvalue.
+             */
+            template <class Component>
+            void add(entity const &e, Component &&value)
+            {
+                _queue<std::decay_t<Component>>().push({ e, std::forward<Component>(value) });
+            }
+
+            /**
+             * @brief This method records the addition of a component constructed from parameters, played back as
+             * add_component.
+             * @tparam Component This template refers to the type of the component.
+             * @tparam Params This variadic template refers to the type of the parameters to pass to the component's
+             * constructor.
+             * @param [in] e This parameter refers to the entity to add the component to.
+             * @param [in] p This parameter refers to the parameters to pass to the constructor, called right away.
+             */
+            template <class Component, class ... Params>
+            void emplace(entity const &e, Params &&... p)
+            {
+                _queue<Component>().push({ e, std::nullopt }).value.emplace(std::forward<Params>(p)...);
+            }
+
+            /**
+             * @brief This method records the removal of a component from an entity, played back as remove_component.
+             * @tparam Component This template refers to the type of the component.
+             * @param [in] e This parameter refers to the entity to remove the component from.
+             */
+            template <class Component>
+            void remove(entity const &e)
+            {
+                _queue<Component>().push({ e, std::nullopt });
+            }
+
+            /**
+             * @brief This method records the death of an entity, played back by kill_entities once the components
+             * commands are applied.
+             * @param [in] e This parameter refers to the entity to kill.
+             */
+            void kill(entity const &e);
+
+            /**
+             * @brief This method checks whether the buffer holds no command.
+             */
+            [[nodiscard]] bool empty() const noexcept;
+
+            /**
+             * @brief This method drops the commands recorded, keeping the memory they use.
+             */
+            void clear() noexcept;
+
+            /**
+             * @brief This method applies the commands to a registry then clears the buffer. The commands of each
+             * component, in component_id order, are applied block of entity indexes by block; the commands of an
+             * entity are applied in the order they were recorded, as add_component and remove_component would, so
+             * the component is left with the last value added or removed if the last command is a removal. The
+             * entities are then killed. Commands targeting an entity that is not alive at that point are ignored.
+             * @param [in] r This parameter refers to the registry, every component commanded must be registered.
+             * @throw If a component is not registered into the registry, the method throws a
+             * component_not_registered_exception and the remaining commands are dropped.
+             */
+            void play(registry &r);
+
+        private:
+            struct queue_base
+            {
+                virtual ~queue_base() = default;
+
+                virtual void play(registry &r) = 0;
+
+                virtual void clear() noexcept = 0;
+
+                [[nodiscard]] virtual bool empty() const noexcept = 0;
+            };
+
+            /**
+             * @brief Entity indexes whose commands are grouped in a block, a page of most containers.
+             */
+            static constexpr unsigned _block_bits = 12;
+
+            /**
+             * @brief The commands of a component, per block of entity indexes, in the order they are recorded. A
+             * command without value is a removal. The blocks and the entities and values inserted are kept between
+             * plays, so recording allocates nothing once the buffer has grown.
+             */
+            template <class Component>
+            struct component_queue final : queue_base
+            {
+                struct command
+                {
+                    entity target;
+
+                    std::optional<Component> value;
+                };
+
+                component_queue() :
+                    blocks{},
+                    count(0),
+                    inserted{},
+                    values{}
+                {}
+
+                std::vector<std::vector<command>> blocks;
+
+                std::size_t count;
+
+                std::vector<entity> inserted;
+
+                std::vector<Component> values;
+
+                command &push(command &&c)
+                {
+                    const std::size_t block = c.target.index() >> _block_bits;
+
+                    if (block >= blocks.size())
+                        blocks.resize(block + 1);
+                    count++;
+                    return blocks[block].emplace_back(std::move(c));
+                }
+
+                void play(registry &r) override;
+
+                void clear() noexcept override
+                {
+                    for (auto &block : blocks)
+                        block.clear();
+                    count = 0;
+                }
+
+                [[nodiscard]] bool empty() const noexcept override
+                {
+                    return count == 0;
+                }
+            };
+
+            /**
+             * @brief Commands of each component, indexed by component_id.
+             */
+            std::vector<std::unique_ptr<queue_base>> _queues;
+
+            std::vector<entity> _kills;
+
+            template <class Component>
+            [[nodiscard]] component_queue<Component> &_queue()
+            {
+                const std::size_t id = component_id::get<Component>();
+
+                if (id >= _queues.size())
+                    _queues.resize(id + 1);
+                if (!_queues[id])
+                    _queues[id] = std::make_unique<component_queue<Component>>();
+                return static_cast<component_queue<Component> &>(*_queues[id]);
+            }
+    };
+}
+
+#endif //COMMAND_BUFFER_HPP
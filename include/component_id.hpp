@@ -0,0 +1,40 @@
+#ifndef COMPONENT_ID_HPP
+#define COMPONENT_ID_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+namespace ecs
+{
+    /**
+     * @brief This class gives every component type a dense integer id, assigned the first time the id of the type is
+     * requested. Ids are shared by all the registries of the process, which use them to index their pools.
+     */
+    class component_id
+    {
+        public:
+            /**
+             * @brief This method returns the id of a component type. cv-qualified types share the id of the
+             * unqualified type.
+             * @tparam Component This template refers to the component type.
+             */
+            template<class Component>
+            [[nodiscard]] static std::size_t get() noexcept
+            {
+                return _id<std::remove_cv_t<Component>>();
+            }
+
+        private:
+            template<class Component>
+            [[nodiscard]] static std::size_t _id() noexcept
+            {
+                static const std::size_t id = _next();
+
+                return id;
+            }
+
+            static std::size_t _next() noexcept;
+    };
+}
+
+#endif //COMPONENT_ID_HPP
@@ -0,0 +1,178 @@
+#ifndef COMPONENT_POOL_HPP
+#define COMPONENT_POOL_HPP
+
+#include <memory>
+#include <typeinfo>
+#include <memory_resource>
+
+#include "component_storage.hpp"
+#include "is_soa_array.hpp"
+#include "is_sparse_array.hpp"
+#include "pool_base.hpp"
+#include "snapshot.hpp"
+#include "exceptions/changes_not_tracked_exception.hpp"
+
+namespace ecs
+{
+    /**
+     * @brief This class refers to the pool of a component: it owns the container of the component and implements
+     * pool_base on top of it.
+     * @tparam Storage This template refers to the type of the container (sparse_array or sparse_set). A container whose
+     * allocator can be built from a std::pmr::memory_resource (see ecs::pmr) allocates from the resource of the pool.
+     */
+    template<class Storage>
+    class component_pool final : public pool_base
+    {
+        public:
+            component_pool() :
+                component_pool(std::pmr::get_default_resource())
+            {}
+
+            explicit component_pool(std::pmr::memory_resource *resource) :
+                _storage(make_storage<Storage>(resource))
+            {}
+
+            component_pool(component_pool const &other, std::pmr::memory_resource *resource) :
+                pool_base(other),
+                _storage(copy_storage(other._storage, resource))
+            {}
+
+            /**
+             * @brief This method returns the container of the pool.
+             */
+            [[nodiscard]] Storage &storage() noexcept
+            {
+                return _storage;
+            }
+
+            [[nodiscard]] Storage const &storage() const noexcept
+            {
+                return _storage;
+            }
+
+            void remove(entity const &e) override
+            {
+                _storage.erase(e);
+            }
+
+            /**
+             * @brief The containers holding a presence bitset erase the components in one pass (see
+             * sparse_array::erase_range), sparse sets erase them one by one.
+             */
+            void remove(entity const *entities, std::size_t count) override
+            {
+                if constexpr (assertion::has_presence_v<Storage>)
+                    _storage.erase_range(entities, entities + count);
+                else
+                    for (std::size_t i = 0; i < count; ++i)
+                        _storage.erase(entities[i]);
+            }
+
+            [[nodiscard]] bool contains(entity const &e) const noexcept override
+            {
+                return _storage.contains(e);
+            }
+
+            [[nodiscard]] std::size_t size() const noexcept override
+            {
+                return _storage.count();
+            }
+
+            void clear() override
+            {
+                _storage.clear();
+            }
+
+            void reserve(std::size_t n) override
+            {
+                _storage.reserve(n);
+            }
+
+            [[nodiscard]] std::unique_ptr<pool_base> clone(std::pmr::memory_resource *resource) const override
+            {
+                return std::make_unique<component_pool>(*this, resource);
+            }
+
+            void copy_from(pool_base const &other) override
+            {
+                pool_base::operator=(other);
+                _storage = static_cast<component_pool const &>(other)._storage;
+            }
+
+            void save(std::ostream &out) const override
+            {
+                snapshot::save(out, _storage);
+            }
+
+            void load(std::istream &in, std::size_t entities) override
+            {
+                snapshot::load(in, _storage, entities);
+            }
+
+            void set_tick(std::uint64_t tick) noexcept override
+            {
+                if constexpr (tracked)
+                    _storage.set_tick(tick);
+            }
+
+            void track_changes(bool enabled) override
+            {
+                if constexpr (tracked)
+                    _storage.track_changes(enabled);
+                else
+                    throw exceptions::changes_not_tracked_exception(type());
+            }
+
+            [[nodiscard]] bool tracks_changes() const noexcept override
+            {
+                if constexpr (tracked)
+                    return _storage.tracks_changes();
+                else
+                    return false;
+            }
+
+            void collect_changes(std::uint64_t since, component_changes &changes) const override
+            {
+                if constexpr (tracked) {
+                    _storage.each_change(since, [&changes](std::size_t pos, bool added) {
+                        (added ? changes.added : changes.changed).push_back(pos);
+                    });
+                    _storage.each_removal(since, [&changes](std::size_t pos) {
+                        changes.removed.push_back(pos);
+                    });
+                }
+            }
+
+            void discard_changes(std::uint64_t until) override
+            {
+                if constexpr (tracked)
+                    _storage.discard_removals(until);
+            }
+
+            void save_changes(std::ostream &out, std::uint64_t since) const override
+            {
+                if constexpr (tracked)
+                    snapshot::save_changes(out, _storage, since);
+            }
+
+            void load_changes(std::istream &in, std::size_t entities) override
+            {
+                if constexpr (tracked)
+                    snapshot::load_changes(in, _storage, entities);
+                else
+                    throw exceptions::changes_not_tracked_exception(type());
+            }
+
+            [[nodiscard]] std::type_info const &type() const noexcept override
+            {
+                return typeid(typename Storage::component_type);
+            }
+
+        private:
+            static constexpr bool tracked = assertion::is_sparse_array_v<Storage>;
+
+            Storage _storage;
+    };
+}
+
+#endif //COMPONENT_POOL_HPP
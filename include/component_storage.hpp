@@ -0,0 +1,77 @@
+#ifndef COMPONENT_STORAGE_HPP
+#define COMPONENT_STORAGE_HPP
+
+#include <type_traits>
+#include <memory_resource>
+
+#include "soa_array.hpp"
+#include "sparse_array.hpp"
+#include "sparse_set.hpp"
+#include "transient_set.hpp"
+
+namespace ecs
+{
+    /**
+     * @brief The component_storage struct selects the container used by the registry to store a component. Components
+     * are stored in a containers::sparse_array by default. Specialize this struct to pick another container, for
+     * instance a containers::sparse_set for components living on a few entities only:
+     * @code
+     * template<>
+     * struct ecs::component_storage<stunned> { using type = ecs::containers::sparse_set<stunned>; };
+     * @endcode
+     * Components living a single frame (events, commands...) can be stored in a containers::transient_set, which the
+     * registry clears at the end of run_systems. Aggregate components of arithmetic fields read by tight loops
+     * (positions, velocities...) can be stored field by field in a containers::soa_array (see ecs::soa_fields).
+     * Only the components stored in a containers::sparse_array can track their changes (see registry::track_changes)
+     * and be part of a delta snapshot.
+     * @tparam Component This template parameter refers to the component to store.
+     */
+    template<class Component>
+    struct component_storage
+    {
+        using type = containers::sparse_array<Component>;
+    };
+
+    template<class Component>
+    using component_storage_t = typename component_storage<Component>::type;
+
+    /**
+     * @brief True when the allocator of a container can be built from a std::pmr::memory_resource (see ecs::pmr).
+     */
+    template<class Storage>
+    constexpr inline bool uses_memory_resource_v = std::is_constructible_v<
+        typename Storage::allocator_type,
+        std::pmr::memory_resource *
+    >;
+
+    /**
+     * @brief This function creates an empty container, allocating from a memory resource if the container can.
+     * @tparam Storage This template refers to the type of the container.
+     * @param [in] resource This parameter refers to the memory resource.
+     */
+    template<class Storage>
+    [[nodiscard]] Storage make_storage(std::pmr::memory_resource *resource)
+    {
+        if constexpr (uses_memory_resource_v<Storage>)
+            return Storage(typename Storage::allocator_type(resource));
+        else
+            return Storage();
+    }
+
+    /**
+     * @brief This function copies a container, the copy allocating from a memory resource if the container can.
+     * @tparam Storage This template refers to the type of the container.
+     * @param [in] other This parameter refers to the container to copy.
+     * @param [in] resource This parameter refers to the memory resource.
+     */
+    template<class Storage>
+    [[nodiscard]] Storage copy_storage(Storage const &other, std::pmr::memory_resource *resource)
+    {
+        if constexpr (uses_memory_resource_v<Storage>)
+            return Storage(other, typename Storage::allocator_type(resource));
+        else
+            return Storage(other);
+    }
+}
+
+#endif //COMPONENT_STORAGE_HPP
@@ -2,20 +2,30 @@
 #define ENTITY_HPP
 
 #include <cstdlib>
+#include <cstdint>
 
 namespace ecs
 {
     class registry;
 
+    class entity_pool;
+
     /**
      * @class entity
      * @brief This class refers to an entity that will be used in the registry.
-     * It will be bound to components and used by systems.
+     * It will be bound to components and used by systems. An entity is made of an index, used to address its
+     * components, and a generation incremented every time the index is recycled, so a handle kept after the entity was
+     * killed never aliases the entity reusing its index.
      */
     class entity
     {
         public:
             friend registry;
+            friend entity_pool;
+
+            using index_type = std::uint32_t;
+
+            using generation_type = std::uint32_t;
 
             entity(entity const &other) noexcept = default;
             entity(entity &&other) noexcept = default;
@@ -24,12 +34,35 @@ namespace ecs
 
             ~entity() = default;
 
+            /**
+             * @brief Returns the index of the entity.
+             */
             operator std::size_t() const noexcept;
 
+            /**
+             * @brief Returns the index of the entity.
+             */
+            [[nodiscard]] index_type index() const noexcept;
+
+            /**
+             * @brief Returns the generation of the entity.
+             */
+            [[nodiscard]] generation_type generation() const noexcept;
+
+            friend inline bool operator==(entity const &lhs, entity const &rhs) noexcept
+            {
+                return (lhs._id == rhs._id);
+            }
+
+            friend inline bool operator!=(entity const &lhs, entity const &rhs) noexcept
+            {
+                return (lhs._id != rhs._id);
+            }
+
         private:
-            explicit entity(std::size_t id) noexcept;
+            entity(index_type index, generation_type generation) noexcept;
 
-            std::size_t _id;
+            std::uint64_t _id;
     };
 }
 
@@ -0,0 +1,259 @@
+#ifndef ENTITY_GROUP_HPP
+#define ENTITY_GROUP_HPP
+
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <typeinfo>
+#include <type_traits>
+
+#include "component_id.hpp"
+#include "component_pool.hpp"
+#include "component_storage.hpp"
+#include "entity.hpp"
+#include "entity_pool.hpp"
+#include "indexed_zipper.hpp"
+#include "pool_base.hpp"
+#include "sparse_set.hpp"
+
+namespace ecs
+{
+    /**
+     * @brief This class refers to the type erased interface of an entity_group, used by the registry to keep its
+     * groups up to date.
+     */
+    class group_base
+    {
+        public:
+            using pool_list = std::vector<std::unique_ptr<pool_base>>;
+
+            group_base() noexcept = default;
+
+            group_base(group_base const &other) = default;
+
+            group_base(group_base &&other) noexcept = default;
+
+            virtual ~group_base() = default;
+
+            group_base &operator=(group_base const &other) = default;
+
+            group_base &operator=(group_base &&other) noexcept = default;
+
+            /**
+             * @brief This method adds an entity to the group if it owns all the components of the group.
+             * @param [in] e This parameter refers to the entity.
+             */
+            virtual void refresh(entity const &e) = 0;
+
+            /**
+             * @brief This method removes an entity from the group. Does nothing if the entity is not in the group.
+             * @param [in] e This parameter refers to the entity.
+             */
+            virtual void erase(entity const &e) = 0;
+
+            /**
+             * @brief This method removes every entity from the group.
+             */
+            virtual void clear() noexcept = 0;
+
+            /**
+             * @brief This method refills the group by scanning the pools of its components. Components owned by
+             * indexes without an alive entity are skipped.
+             * @param [in] entities This parameter refers to the entity pool of the registry, giving the entity of an
+             * index.
+             */
+            virtual void rebuild(entity_pool const &entities) = 0;
+
+            /**
+             * @brief This method checks whether a component is one of the components of the group.
+             * @param [in] id This parameter refers to the id of the component (see component_id).
+             */
+            [[nodiscard]] virtual bool uses(std::size_t id) const noexcept = 0;
+
+            /**
+             * @brief This method returns a copy of the group bound to the pools of another registry.
+             * @param [in] pools This parameter refers to the pools of the registry, indexed by component_id.
+             */
+            [[nodiscard]] virtual std::unique_ptr<group_base> clone(pool_list const &pools) const = 0;
+
+            /**
+             * @brief This method replaces the entities of the group with those of another group of the same type,
+             * reusing the storage already allocated. The group stays bound to its pools.
+             * @param [in] other This parameter refers to the group to copy.
+             */
+            virtual void copy_from(group_base const &other) = 0;
+
+            /**
+             * @brief This method returns the type of the group.
+             */
+            [[nodiscard]] virtual std::type_info const &type() const noexcept = 0;
+    };
+
+    /**
+     * @brief This class refers to the packed list of the entities owning all the given components, built once by
+     * registry::group and kept up to date as components are added and removed through the registry (see
+     * registry::on_construct and registry::on_destroy). Iterating over it walks an array instead of scanning the
+     * containers of the components. Entities are iterated over in the order they joined the group.
+     * @warning Components added or removed through get_component bypass the group. The components of the group must not
+     * be added nor removed while iterating over it, and systems running concurrently (see registry::set_concurrency)
+     * must not add nor remove components of the same group.
+     * @tparam Components This variadic template refers to the components, a const component is passed as a const
+     * reference by each.
+     */
+    template<class ... Components>
+    class entity_group final : public group_base
+    {
+        public:
+            using container_type = containers::sparse_set<entity>;
+
+            using const_iterator = typename container_type::const_iterator;
+
+            using size_type = typename container_type::size_type;
+
+            /**
+             * @param [in] pools This parameter refers to the pools of the registry, indexed by component_id. The
+             * pools of all the components must be registered.
+             */
+            explicit entity_group(pool_list const &pools) :
+                _storages(&_storage<Components>(pools)...),
+                _entities{}
+            {}
+
+            [[nodiscard]] const_iterator begin() const
+            {
+                return _entities.begin();
+            }
+
+            [[nodiscard]] const_iterator end() const
+            {
+                return _entities.end();
+            }
+
+            /**
+             * @brief This method returns the number of entities of the group.
+             */
+            [[nodiscard]] size_type size() const noexcept
+            {
+                return _entities.size();
+            }
+
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return _entities.empty();
+            }
+
+            /**
+             * @brief This method checks whether an entity is part of the group.
+             * @param [in] e This parameter refers to the entity.
+             */
+            [[nodiscard]] bool contains(entity const &e) const noexcept
+            {
+                return _entities.contains(e.index()) && _entities.get(e.index()) == e;
+            }
+
+            /**
+             * @brief This method calls a function for every entity of the group.
+             * @tparam Function This template refers to the type of the function, called as f(entity, components...).
+             * @param [in] f This parameter refers to the function to call.
+             */
+            template<class Function>
+            void each(Function &&f) const
+            {
+                _each(std::forward<Function>(f), std::index_sequence_for<Components...>());
+            }
+
+            void refresh(entity const &e) override
+            {
+                if (!contains(e) && _owns(e, std::index_sequence_for<Components...>()))
+                    _entities.insert_at(e.index(), e);
+            }
+
+            void erase(entity const &e) override
+            {
+                if (contains(e))
+                    _entities.erase(e.index());
+            }
+
+            void clear() noexcept override
+            {
+                _entities.clear();
+            }
+
+            void rebuild(entity_pool const &entities) override
+            {
+                _entities.clear();
+                std::apply([this, &entities](auto *... storages) {
+                    for (auto &&components : containers::indexed_zipper(std::as_const(*storages)...)) {
+                        const std::size_t index = std::get<0>(components);
+
+                        if (index < entities.size() && entities.valid(entities.at(index)))
+                            _entities.insert_at(index, entities.at(index));
+                    }
+                }, _storages);
+            }
+
+            [[nodiscard]] bool uses(std::size_t id) const noexcept override
+            {
+                return ((id == component_id::get<Components>()) || ...);
+            }
+
+            [[nodiscard]] std::unique_ptr<group_base> clone(pool_list const &pools) const override
+            {
+                auto copy = std::make_unique<entity_group>(pools);
+
+                copy->_entities = _entities;
+                return copy;
+            }
+
+            void copy_from(group_base const &other) override
+            {
+                _entities = static_cast<entity_group const &>(other)._entities;
+            }
+
+            [[nodiscard]] std::type_info const &type() const noexcept override
+            {
+                return typeid(entity_group);
+            }
+
+        private:
+            template<class Component>
+            using storage_t = component_storage_t<std::remove_const_t<Component>>;
+
+            std::tuple<storage_t<Components> *...> _storages;
+
+            container_type _entities;
+
+            template<class Component>
+            [[nodiscard]] static storage_t<Component> &_storage(pool_list const &pools)
+            {
+                return static_cast<component_pool<storage_t<Component>> &>(
+                    *pools[component_id::get<Component>()]
+                ).storage();
+            }
+
+            template<std::size_t ... Is>
+            [[nodiscard]] bool _owns(entity const &e, std::index_sequence<Is...>) const noexcept
+            {
+                return (std::get<Is>(_storages)->contains(e.index()) && ...);
+            }
+
+            template<class Function, std::size_t ... Is>
+            void _each(Function &&f, std::index_sequence<Is...>) const
+            {
+                for (auto const &e : _entities)
+                    f(e, _component<Components>(*std::get<Is>(_storages), e)...);
+            }
+
+            template<class Component, class Storage>
+            [[nodiscard]] static decltype(auto) _component(Storage &storage, entity const &e)
+            {
+                if constexpr (std::is_const_v<Component>)
+                    return std::as_const(storage).get(e.index());
+                else
+                    return storage.get(e.index());
+            }
+    };
+}
+
+#endif //ENTITY_GROUP_HPP
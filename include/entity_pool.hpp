@@ -0,0 +1,190 @@
+#ifndef ENTITY_POOL_HPP
+#define ENTITY_POOL_HPP
+
+#include <iosfwd>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include "entity.hpp"
+
+namespace ecs
+{
+    /**
+     * @brief This class spawns, recycles and validates entities. Every index ever spawned owns a slot holding the
+     * current entity of this index. Slots of killed entities are chained together in an implicit free list: their
+     * index field holds the index of the next free slot and their generation field the generation the index will be
+     * respawned with. The free list is doubly linked so any free index can be taken out of it in constant time.
+     */
+    class entity_pool
+    {
+        public:
+            entity_pool() noexcept;
+
+            /**
+             * @brief This method spawns an entity, recycling the index of the last killed entity if any.
+             * @return The spawned entity.
+             */
+            entity spawn();
+
+            /**
+             * @brief This method spawns several entities, recycling the indexes of killed entities first. Storage is
+             * grown once for all the entities.
+             * @tparam OutputIt This template refers to the type of the iterator receiving the entities.
+             * @param [in] n This parameter refers to the number of entities to spawn.
+             * @param [out] out This parameter refers to the iterator receiving the spawned entities.
+             * @return The iterator following the last entity written.
+             */
+            template<class OutputIt>
+            OutputIt spawn_n(std::size_t n, OutputIt out)
+            {
+                spawn_reserved();
+                _reserve(_slots.size() + (n > _freeCount ? n - _freeCount : 0));
+                for (; n > 0; --n)
+                    *out++ = spawn();
+                return out;
+            }
+
+            /**
+             * @brief This method spawns an entity with a given index.
+             * @param [in] index This parameter refers to the index of the entity to spawn.
+             * @return The spawned entity.
+             * @throw May throw a runtime_error "entity already spawned." if an entity with the given index is alive.
+             */
+            entity spawn_at(std::size_t index);
+
+            /**
+             * @brief This method spawns an entity for every index of a range. Either all entities are spawned or none.
+             * @tparam OutputIt This template refers to the type of the iterator receiving the entities.
+             * @param [in] first This parameter refers to the first index to spawn.
+             * @param [in] last This parameter refers to the index following the last index to spawn.
+             * @param [out] out This parameter refers to the iterator receiving the spawned entities, in index order.
+             * @return The iterator following the last entity written.
+             * @throw May throw a runtime_error "entity already spawned." if an entity of the range is alive.
+             */
+            template<class OutputIt>
+            OutputIt spawn_range(std::size_t first, std::size_t last, OutputIt out)
+            {
+                spawn_reserved();
+                _claim(first, last);
+                for (std::size_t i = first; i < last; ++i)
+                    *out++ = _slots[i];
+                return out;
+            }
+
+            /**
+             * @brief This method reserves an entity to spawn later. Reserved entities take the indexes following the
+             * slots, killed indexes are not recycled, and are not valid until spawned by spawn_reserved, which every
+             * spawn method calls first. It is the only method that may be called concurrently, with itself, for
+             * instance by systems running concurrently (see registry::reserve_entity).
+             * @return The reserved entity.
+             */
+            entity reserve() noexcept;
+
+            /**
+             * @brief This method spawns the entities reserved since the last call, in reservation order.
+             */
+            void spawn_reserved();
+
+            /**
+             * @brief This method kills an entity, its index will be recycled with a new generation.
+             * @param [in] e This parameter refers to the entity to kill.
+             * @return false if the entity was not alive, true otherwise.
+             */
+            bool kill(entity const &e) noexcept;
+
+            /**
+             * @brief This method checks whether an entity is alive. Handles of killed entities are never valid, even
+             * once their index has been recycled.
+             * @param [in] e This parameter refers to the entity to check.
+             */
+            [[nodiscard]] bool valid(entity const &e) const noexcept;
+
+            /**
+             * @brief This method checks that an entity is alive before a component is written to it.
+             * @param [in] e This parameter refers to the entity to check.
+             * @throw If the entity is not alive (see valid), the method throws an exceptions::invalid_entity_exception.
+             */
+            void check(entity const &e) const;
+
+            /**
+             * @brief This method returns the entity stored in the slot of an index, valid only if the entity of the
+             * index is alive (see valid).
+             * @param [in] index This parameter refers to the index, it must be lower than size().
+             */
+            [[nodiscard]] entity at(std::size_t index) const noexcept;
+
+            /**
+             * @brief This method returns the number of slots, that is the highest index ever spawned plus one.
+             */
+            [[nodiscard]] std::size_t size() const noexcept;
+
+            /**
+             * @brief This method writes the slots and the free list of the pool to a snapshot.
+             * @param [in] out This parameter refers to the stream to write to.
+             * @throw If the stream fails, the method throws an exceptions::snapshot_exception.
+             */
+            void save(std::ostream &out) const;
+
+            /**
+             * @brief This method replaces the content of the pool with the content read from a snapshot.
+             * @param [in] in This parameter refers to the stream to read from.
+             * @throw If the snapshot is truncated or corrupted, the method throws an exceptions::snapshot_exception and
+             * the pool is left unchanged.
+             */
+            void load(std::istream &in);
+
+        private:
+            static constexpr entity::index_type _null = std::numeric_limits<entity::index_type>::max();
+
+            /**
+             * @brief Number of entities reserved, copied along the pool.
+             */
+            struct reservations
+            {
+                std::atomic<std::size_t> count{0};
+
+                reservations() noexcept = default;
+
+                reservations(reservations const &other) noexcept :
+                    count(other.count.load(std::memory_order_relaxed))
+                {}
+
+                reservations &operator=(reservations const &other) noexcept
+                {
+                    count.store(other.count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    return *this;
+                }
+            };
+
+            std::vector<entity> _slots;
+
+            /**
+             * @brief For every free slot, the index of the previous slot in the free list, or _null for the head.
+             */
+            std::vector<entity::index_type> _prev;
+
+            entity::index_type _freeHead;
+
+            std::size_t _freeCount;
+
+            reservations _reserved;
+
+            void _link(entity::index_type index, entity::generation_type generation) noexcept;
+
+            void _unlink(entity::index_type index) noexcept;
+
+            /**
+             * @brief Checks that the free list of a loaded pool links count free slots, and only them.
+             */
+            [[nodiscard]] bool _check_free_list(std::size_t count) const noexcept;
+
+            void _grow(std::size_t size);
+
+            void _reserve(std::size_t size);
+
+            void _claim(std::size_t first, std::size_t last);
+    };
+}
+
+#endif //ENTITY_POOL_HPP
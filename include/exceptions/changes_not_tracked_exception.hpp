@@ -0,0 +1,34 @@
+#ifndef CHANGES_NOT_TRACKED_EXCEPTION_HPP
+#define CHANGES_NOT_TRACKED_EXCEPTION_HPP
+
+#include <exception>
+#include <string>
+#include <typeinfo>
+
+namespace ecs::exceptions
+{
+    /**
+     * @brief This exception will be thrown when the changes of a component are tracked or applied while the component
+     * is not stored in a sparse_array, the only container able to track them.
+     */
+    class changes_not_tracked_exception : public std::exception
+    {
+        public:
+            /**
+             * @param [in] component This parameter refers to the component whose changes were requested.
+             */
+            explicit changes_not_tracked_exception(std::type_info const &component);
+
+            /**
+             * @brief Returns a C-style character string describing the general cause of the current error.
+             */
+            [[nodiscard]] const char *what() const noexcept override;
+
+            ~changes_not_tracked_exception() override = default;
+
+        private:
+            std::string _errorMessage{};
+    };
+}
+
+#endif //CHANGES_NOT_TRACKED_EXCEPTION_HPP
@@ -0,0 +1,35 @@
+#ifndef INVALID_ENTITY_EXCEPTION_HPP
+#define INVALID_ENTITY_EXCEPTION_HPP
+
+#include <exception>
+#include <string>
+
+#include "entity.hpp"
+
+namespace ecs::exceptions
+{
+    /**
+     * @brief This exception will be thrown when a component is added to or modified on an entity that is not alive:
+     * killed, whose index was recycled, or reserved and not spawned yet.
+     */
+    class invalid_entity_exception : public std::exception
+    {
+        public:
+            /**
+             * @param [in] e This parameter refers to the entity that is not alive.
+             */
+            explicit invalid_entity_exception(entity const &e);
+
+            /**
+             * @brief Returns a C-style character string describing the general cause of the current error.
+             */
+            [[nodiscard]] const char *what() const noexcept override;
+
+            ~invalid_entity_exception() override = default;
+
+        private:
+            std::string _errorMessage{};
+    };
+}
+
+#endif //INVALID_ENTITY_EXCEPTION_HPP
@@ -0,0 +1,32 @@
+#ifndef SNAPSHOT_EXCEPTION_HPP
+#define SNAPSHOT_EXCEPTION_HPP
+
+#include <exception>
+#include <string>
+
+namespace ecs::exceptions
+{
+    /**
+     * @brief This exception will be thrown when a snapshot of a registry can't be saved or loaded.
+     */
+    class snapshot_exception : public std::exception
+    {
+        public:
+            /**
+             * @param [in] reason This parameter refers to the cause of the error.
+             */
+            explicit snapshot_exception(std::string const &reason);
+
+            /**
+             * @brief Returns a C-style character string describing the general cause of the current error.
+             */
+            [[nodiscard]] const char *what() const noexcept override;
+
+            ~snapshot_exception() override = default;
+
+        private:
+            std::string _errorMessage{};
+    };
+}
+
+#endif //SNAPSHOT_EXCEPTION_HPP
@@ -1,6 +1,16 @@
 #ifndef INDEXED_ZIPPER_HPP
 #define INDEXED_ZIPPER_HPP
 
+#ifdef _WIN32
+#define NOMINMAX
+#endif
+
+#include <tuple>
+#include <algorithm>
+#include "is_soa_array.hpp"
+#include "is_sparse_set.hpp"
+#include "thread_pool.hpp"
+#include "zipper.hpp"
 #include "indexed_zipper_iterator.hpp"
 
 namespace ecs::containers
@@ -10,28 +20,32 @@ namespace ecs::containers
      * that has ALL components. If one component is missing form the entity, the latter will be skipped. This class is
      * the same as the zipper, the only difference is that this one provides you the index of the first entity as the
      * first index of the tuple.
-     * @warning If any of the sparse_array is resized (add entity, add component to an entity that has an index greater
-     * than the size of the sparse_array, etc...) the indexed zipper and all iterators are invalided.
-     * (if u continue using it, the behavior is \b UNDEFINED and crashes / \b SIGSEGV may occur).
-     * @tparam Containers This template parameter refers to the components you want to iterate over.
+     * @warning The range of entities iterated over is computed when the zipper is built: components added afterwards
+     * to an entity with a greater index are not visited. A reference to a component stored in a sparse_set is
+     * invalidated when the sparse_set grows or when a component is erased from it, and components must not be erased
+     * from a sparse_set driving the iteration (see zipper).
+     * @tparam Containers This template parameter refers to the components you want to iterate over, as containers or
+     * containers wrapped in exclude or maybe (see zipper).
      */
     template<class ... Containers>
     class indexed_zipper
     {
-        static_assert((assertion::is_sparse_array_v<Containers> && ...), "Containers must be sparse_array.");
+        static_assert(
+            ((assertion::has_presence_v<zipper_container_t<Containers>> ||
+            assertion::is_sparse_set_v<zipper_container_t<Containers>>) && ...),
+            "Containers must be sparse_array, soa_array or sparse_set."
+        );
 
         public:
             using iterator = iterators::indexed_zipper_iterator<Containers ...>;
-            using iterator_tuple = typename iterator::iterator_tuple;
+            using container_tuple = typename iterator::container_tuple;
 
             /**
              * @param [in | out] cs This parameter refers to the sparse_array containing the component you specified in
              * template.
              */
-            explicit indexed_zipper(Containers &... cs) :
-                _size(_compute_size(cs...)),
-                _begin(cs.begin()...),
-                _end(_compute_end(cs..., _size))
+            explicit indexed_zipper(zipper_parameter_t<Containers>... cs) :
+                _zipper(cs...)
             {}
 
             /**
@@ -40,7 +54,7 @@ namespace ecs::containers
              */
             [[nodiscard]] iterator begin()
             {
-                return iterator(_begin, _size);
+                return iterator(_zipper.begin());
             }
 
             /**
@@ -49,28 +63,33 @@ namespace ecs::containers
              */
             [[nodiscard]] iterator end()
             {
-                return iterator(_end, 0);
+                return iterator(_zipper.end());
             }
 
-        private:
-            size_t _size;
-
-            iterator_tuple _begin;
-
-            iterator_tuple _end;
-
-            [[nodiscard]] static size_t _compute_size(Containers &... containers)
+            /**
+             * @brief This method calls a function for every entity that has ALL components, in parallel. The slots of
+             * the container driving the iteration are split into chunks sized after the components footprint (see
+             * thread_pool::chunk_size), which are processed concurrently by the workers of the pool and the calling
+             * thread.
+             * @warning The function must only access the components of the entity it is called for.
+             * @tparam Function This template refers to the type of the function, called as f(index, components...).
+             * @param [in] pool This parameter refers to the thread_pool to run the function on.
+             * @param [in] f This parameter refers to the function to call.
+             */
+            template<class Function>
+            void par_each(thread_pool &pool, Function &&f)
             {
-                return std::min(
-                    { containers.size()... }
-                );
+                _zipper._parallel(pool, [&f](auto &it) {
+                    std::apply(f, std::tuple_cat(std::tuple<std::size_t>(it.index()), *it));
+                });
             }
 
-            [[nodiscard]] static iterator_tuple _compute_end(Containers &... containers, std::size_t minSize)
-            {
-                return std::tuple((containers.begin() + minSize)...);
-            }
+        private:
+            zipper<Containers ...> _zipper;
     };
+
+    template<class ... Args>
+    indexed_zipper(Args &&...) -> indexed_zipper<std::remove_reference_t<Args>...>;
 }
 
 #endif //INDEXED_ZIPPER_HPP
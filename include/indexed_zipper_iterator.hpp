@@ -1,8 +1,11 @@
 #ifndef INDEXED_ZIPPER_ITERATOR_HPP
 #define INDEXED_ZIPPER_ITERATOR_HPP
 
-#include <algorithm>
-#include "is_sparse_array.hpp"
+#include <tuple>
+#include <utility>
+#include <iterator>
+
+#include "zipper_iterator.hpp"
 
 namespace ecs::containers
 {
@@ -21,45 +24,28 @@ namespace ecs::iterators
     template<class ...Containers>
     class indexed_zipper_iterator
     {
-            template<class Container>
-            using iterator_t = typename Container::iterator;
-
-            template<class Container>
-            using it_reference_t = decltype(std::declval<typename iterator_t<Container>::reference>().value());
+            using base_iterator = zipper_iterator<Containers ...>;
 
         public:
-            using value_type = std::tuple<std::size_t, it_reference_t<Containers>...>;
+            using value_type = decltype(std::tuple_cat(
+                std::declval<std::tuple<std::size_t>>(),
+                std::declval<typename base_iterator::value_type>()
+            ));
             using reference = value_type &;
             using pointer = void;
             using difference_type = std::size_t;
             using iterator_category = std::input_iterator_tag;
-            using iterator_tuple = std::tuple<iterator_t<Containers>...>;
+            using container_tuple = typename base_iterator::container_tuple;
 
             friend ecs::containers::indexed_zipper<Containers ...>;
 
-            indexed_zipper_iterator(indexed_zipper_iterator const &z) :
-                _current(z._current),
-                _max(z._max),
-                _idx(z._idx)
-            {}
+            indexed_zipper_iterator(indexed_zipper_iterator const &z) = default;
 
-            const indexed_zipper_iterator &operator++() //TODO fix this magic operator
+            indexed_zipper_iterator &operator=(indexed_zipper_iterator const &z) = default;
+
+            const indexed_zipper_iterator &operator++()
             {
-                if (_max == 0)
-                    return (*this);
-                if (_idx == _max - 1) {
-                    _incr_all(_seq);
-                    _idx++;
-                }
-                else if (_idx < _max - 1)
-                    do {
-                        _incr_all(_seq);
-                        _idx += 1;
-                    } while (!_all_set(_seq) && _idx < _max - 1);
-                if (_idx == _max - 1 && !_all_set(_seq)) {
-                    _incr_all(_seq);
-                    _idx++;
-                }
+                ++_it;
                 return (*this);
             }
 
@@ -72,60 +58,35 @@ namespace ecs::iterators
 
             value_type operator*()
             {
-                return (_to_value(_seq));
+                return (_to_value());
             }
 
             value_type operator->()
             {
-                return (_to_value(_seq));
+                return (_to_value());
             }
 
             friend inline bool operator==(indexed_zipper_iterator const &lhs, indexed_zipper_iterator const &rhs)
             {
-                return ((lhs._max - lhs._idx) == (rhs._max - rhs._idx));
+                return (lhs._it == rhs._it);
             }
 
             friend inline bool operator!=(indexed_zipper_iterator const &lhs, indexed_zipper_iterator const &rhs)
             {
-                return ((lhs._max - lhs._idx) != (rhs._max - rhs._idx));
+                return (lhs._it != rhs._it);
             }
 
         private:
+            base_iterator _it;
 
-            iterator_tuple _current;
-
-            std::size_t _max;
-
-            std::size_t _idx;
-
-            static constexpr std::index_sequence_for<Containers ...> _seq{};
-
-            template<size_t ... Is>
-            void _incr_all(std::index_sequence<Is ...>)
+            [[nodiscard]] value_type _to_value()
             {
-                ((++std::get<Is>(_current)), ...);
+                return std::tuple_cat(std::tuple<std::size_t>(_it.index()), *_it);
             }
 
-            template<size_t ... Is>
-            [[nodiscard]] bool _all_set(std::index_sequence<Is ...>)
-            {
-                return (((*std::get<Is>(_current)) != std::nullopt) && ...);
-            }
-
-            template<size_t ... Is>
-            [[nodiscard]] value_type _to_value(std::index_sequence<Is ...>)
-            {
-                return std::tie(_idx, std::get<Is>(_current)->value()...);
-            }
-
-            indexed_zipper_iterator(iterator_tuple const &it_tuple, std::size_t max) :
-                _current(it_tuple),
-                _max(max),
-                _idx(0)
-            {
-                if (max > 0 && !_all_set(_seq))
-                    this->operator++();
-            }
+            explicit indexed_zipper_iterator(base_iterator const &it) :
+                _it(it)
+            {}
     };
 }
 
@@ -0,0 +1,34 @@
+#ifndef IS_SOA_ARRAY_HPP
+#define IS_SOA_ARRAY_HPP
+
+#include "is_sparse_array.hpp"
+#include "soa_array.hpp"
+
+namespace ecs::assertion
+{
+    /**
+     * @brief The is_soa_array struct contains a static field named value that is true if the template is a
+     * containers::soa_array<T, Allocator>, const qualified or not. Otherwise the field is equals to false.
+     * @tparam T This template parameter refers to the type to check.
+     */
+    template<class T>
+    struct is_soa_array : std::false_type {};
+
+    template<class T, class Allocator>
+    struct is_soa_array<containers::soa_array<T, Allocator>> : std::true_type {};
+
+    template<class T>
+    struct is_soa_array<T const> : is_soa_array<T> {};
+
+    template<class T>
+    constexpr inline bool is_soa_array_v = is_soa_array<T>::value;
+
+    /**
+     * @brief True when a container is indexed by position and has a presence bitset (sparse_array and soa_array):
+     * the zippers intersect the bitsets instead of probing the container.
+     */
+    template<class T>
+    constexpr inline bool has_presence_v = is_sparse_array_v<T> || is_soa_array_v<T>;
+}
+
+#endif //IS_SOA_ARRAY_HPP
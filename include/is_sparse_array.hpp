@@ -7,15 +7,18 @@ namespace ecs::assertion
 {
     /**
      * @brief The is_sparse_array struct contains a static field named value that is true if the template is a
-     * containers::sparse_array<T>. Otherwise the field is equals to false.
+     * containers::sparse_array<T, Allocator>, const qualified or not. Otherwise the field is equals to false.
      * @tparam T This template parameter refers to the type to check.
      */
     template<class T>
     struct is_sparse_array : std::false_type {};
 
 
+    template<class T, class Allocator>
+    struct is_sparse_array<containers::sparse_array<T, Allocator>> : std::true_type {};
+
     template<class T>
-    struct is_sparse_array<containers::sparse_array<T>> : std::true_type {};
+    struct is_sparse_array<T const> : is_sparse_array<T> {};
 
     template<class T>
     constexpr inline bool is_sparse_array_v = is_sparse_array<T>::value;
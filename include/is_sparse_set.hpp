@@ -0,0 +1,28 @@
+#ifndef IS_SPARSE_SET_HPP
+#define IS_SPARSE_SET_HPP
+
+#include "sparse_set.hpp"
+
+namespace ecs::assertion
+{
+    /**
+     * @brief The is_sparse_set struct contains a static field named value that is true if the template is a
+     * containers::sparse_set<T, Allocator> or a containers::transient_set<T, Allocator>, const qualified or not.
+     * Otherwise the field is equals to false.
+     * @tparam T This template parameter refers to the type to check.
+     */
+    template<class T>
+    struct is_sparse_set : std::false_type {};
+
+
+    template<class T, class Allocator, bool Transient>
+    struct is_sparse_set<containers::sparse_set<T, Allocator, Transient>> : std::true_type {};
+
+    template<class T>
+    struct is_sparse_set<T const> : is_sparse_set<T> {};
+
+    template<class T>
+    constexpr inline bool is_sparse_set_v = is_sparse_set<T>::value;
+}
+
+#endif //IS_SPARSE_SET_HPP
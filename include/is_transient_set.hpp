@@ -0,0 +1,26 @@
+#ifndef IS_TRANSIENT_SET_HPP
+#define IS_TRANSIENT_SET_HPP
+
+#include "transient_set.hpp"
+
+namespace ecs::assertion
+{
+    /**
+     * @brief The is_transient_set struct contains a static field named value that is true if the template is a
+     * containers::transient_set<T, Allocator>, const qualified or not. Otherwise the field is equals to false.
+     * @tparam T This template parameter refers to the type to check.
+     */
+    template<class T>
+    struct is_transient_set : std::false_type {};
+
+    template<class T, class Allocator>
+    struct is_transient_set<containers::sparse_set<T, Allocator, true>> : std::true_type {};
+
+    template<class T>
+    struct is_transient_set<T const> : is_transient_set<T> {};
+
+    template<class T>
+    constexpr inline bool is_transient_set_v = is_transient_set<T>::value;
+}
+
+#endif //IS_TRANSIENT_SET_HPP
@@ -0,0 +1,53 @@
+#ifndef MEMORY_RESOURCE_HPP
+#define MEMORY_RESOURCE_HPP
+
+#include <memory_resource>
+
+#include "soa_array.hpp"
+#include "sparse_array.hpp"
+#include "sparse_set.hpp"
+#include "transient_set.hpp"
+
+/**
+ * @brief Containers allocating from a std::pmr::memory_resource. A registry built on a resource constructs the
+ * containers of these types from it, so that the pages, bitsets and dense arrays of their components are allocated
+ * from an arena or a pool instead of the global heap. The bookkeeping of the registry itself still uses the global
+ * heap:
+ * @code
+ * template<>
+ * struct ecs::component_storage<position> { using type = ecs::pmr::sparse_array<position>; };
+ *
+ * ecs::pmr::arena arena(1 << 20);
+ * ecs::registry r(&arena);
+ * @endcode
+ * The resource must outlive the registry and the copies of the registry. arena and pool are not thread-safe: when
+ * systems run concurrently (see registry::set_concurrency) and insert components, use a
+ * std::pmr::synchronized_pool_resource.
+ */
+namespace ecs::pmr
+{
+    template<typename Component>
+    using sparse_array = containers::sparse_array<Component, std::pmr::polymorphic_allocator<Component>>;
+
+    template<typename Component>
+    using soa_array = containers::soa_array<Component, std::pmr::polymorphic_allocator<Component>>;
+
+    template<typename Component>
+    using sparse_set = containers::sparse_set<Component, std::pmr::polymorphic_allocator<Component>>;
+
+    template<typename Component>
+    using transient_set = containers::transient_set<Component, std::pmr::polymorphic_allocator<Component>>;
+
+    /**
+     * @brief Memory resource handing out memory from a growing buffer and releasing it all at once when destroyed,
+     * for registries whose components are freed together (e.g. the world of a level).
+     */
+    using arena = std::pmr::monotonic_buffer_resource;
+
+    /**
+     * @brief Memory resource recycling blocks by size, for registries whose components come and go.
+     */
+    using pool = std::pmr::unsynchronized_pool_resource;
+}
+
+#endif //MEMORY_RESOURCE_HPP
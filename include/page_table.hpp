@@ -0,0 +1,215 @@
+#ifndef PAGE_TABLE_HPP
+#define PAGE_TABLE_HPP
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <utility>
+
+namespace ecs::containers
+{
+    /**
+     * @brief This class refers to a table of fixed-size pages allocated on demand with an allocator. It is the storage
+     * shared by the paged containers: a page never moves once allocated.
+     * @tparam T This template refers to the type of the elements of a page.
+     * @tparam PageSize This template refers to the number of elements of a page.
+     * @tparam Allocator This template refers to the allocator, rebound to allocate the pages and the table.
+     */
+    template<class T, std::size_t PageSize, class Allocator>
+    class page_table
+    {
+        public:
+            using page_type = std::array<T, PageSize>;
+
+            using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<page_type>;
+
+            using size_type = std::size_t;
+
+            explicit page_table(allocator_type const &allocator) :
+                _allocator(allocator),
+                _pages(pointer_allocator(allocator))
+            {}
+
+            page_table(page_table const &other, allocator_type const &allocator) :
+                page_table(allocator)
+            {
+                _pages.resize(other._pages.size(), nullptr);
+                try {
+                    for (size_type i = 0; i < other._pages.size(); ++i)
+                        if (other._pages[i])
+                            _pages[i] = _make(*other._pages[i]);
+                } catch (...) {
+                    _release();
+                    throw;
+                }
+            }
+
+            page_table(page_table const &other) :
+                page_table(other, traits::select_on_container_copy_construction(other._allocator))
+            {}
+
+            page_table(page_table &&other) noexcept :
+                _allocator(std::move(other._allocator)),
+                _pages(std::move(other._pages))
+            {
+                other._pages.clear();
+            }
+
+            ~page_table()
+            {
+                _release();
+            }
+
+            /**
+             * @brief The pages allocated in both tables are copied in place, without being reallocated: copying a
+             * table into a table of the same shape allocates nothing, and pages of trivially copyable elements are
+             * copied as raw blocks. Pages missing from other are released. If copying an element throws, the table
+             * holds a mix of the two tables.
+             */
+            page_table &operator=(page_table const &other)
+            {
+                if (this == &other)
+                    return (*this);
+                for (size_type i = other._pages.size(); i < _pages.size(); ++i)
+                    _destroy(_pages[i]);
+                _pages.resize(other._pages.size(), nullptr);
+                for (size_type i = 0; i < other._pages.size(); ++i) {
+                    if (!other._pages[i])
+                        _destroy(_pages[i]);
+                    else if (_pages[i])
+                        *_pages[i] = *other._pages[i];
+                    else
+                        _pages[i] = _make(*other._pages[i]);
+                }
+                return (*this);
+            }
+
+            /**
+             * @brief Pages are stolen when the allocators allow it, otherwise their elements are moved to pages
+             * allocated with the allocator of this table. other is left empty either way.
+             */
+            page_table &operator=(page_table &&other) noexcept(
+                traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value)
+            {
+                if (this == &other)
+                    return (*this);
+                if constexpr (traits::propagate_on_container_move_assignment::value) {
+                    _release();
+                    _allocator = std::move(other._allocator);
+                    _pages = std::move(other._pages);
+                } else {
+                    if (_allocator == other._allocator) {
+                        _release();
+                        _pages = std::move(other._pages);
+                    } else {
+                        page_table moved(_allocator);
+
+                        moved._pages.resize(other._pages.size(), nullptr);
+                        for (size_type i = 0; i < other._pages.size(); ++i)
+                            if (other._pages[i])
+                                moved._pages[i] = moved._make(std::move(*other._pages[i]));
+                        _swap_pages(moved);
+                        other._release();
+                    }
+                }
+                other._pages.clear();
+                return (*this);
+            }
+
+            /**
+             * @brief This method returns a page, or nullptr if it is not allocated.
+             */
+            [[nodiscard]] page_type *operator[](size_type page) const noexcept
+            {
+                return _pages[page];
+            }
+
+            /**
+             * @brief This method returns a page, allocating it if needed. The table must cover the page.
+             */
+            page_type &allocate(size_type page)
+            {
+                if (!_pages[page])
+                    _pages[page] = _make();
+                return (*_pages[page]);
+            }
+
+            /**
+             * @brief This method returns the number of pages covered by the table, allocated or not.
+             */
+            [[nodiscard]] size_type size() const noexcept
+            {
+                return _pages.size();
+            }
+
+            /**
+             * @brief This method grows the table to cover a given number of pages. Pages are not allocated.
+             */
+            void resize(size_type pages)
+            {
+                if (pages > _pages.size())
+                    _pages.resize(pages, nullptr);
+            }
+
+            [[nodiscard]] auto begin() const noexcept
+            {
+                return _pages.begin();
+            }
+
+            [[nodiscard]] auto end() const noexcept
+            {
+                return _pages.end();
+            }
+
+            [[nodiscard]] allocator_type get_allocator() const noexcept
+            {
+                return _allocator;
+            }
+
+        private:
+            using traits = std::allocator_traits<allocator_type>;
+
+            using pointer_allocator = typename traits::template rebind_alloc<page_type *>;
+
+            allocator_type _allocator;
+
+            std::vector<page_type *, pointer_allocator> _pages;
+
+            template<class ... Args>
+            [[nodiscard]] page_type *_make(Args &&...args)
+            {
+                page_type *page = traits::allocate(_allocator, 1);
+
+                try {
+                    traits::construct(_allocator, page, std::forward<Args>(args)...);
+                } catch (...) {
+                    traits::deallocate(_allocator, page, 1);
+                    throw;
+                }
+                return (page);
+            }
+
+            void _destroy(page_type *&page) noexcept
+            {
+                if (page) {
+                    traits::destroy(_allocator, page);
+                    traits::deallocate(_allocator, page, 1);
+                    page = nullptr;
+                }
+            }
+
+            void _release() noexcept
+            {
+                for (auto *&page : _pages)
+                    _destroy(page);
+                _pages.clear();
+            }
+
+            void _swap_pages(page_table &other) noexcept
+            {
+                _pages.swap(other._pages);
+            }
+    };
+}
+
+#endif //PAGE_TABLE_HPP
@@ -0,0 +1,214 @@
+#ifndef POOL_BASE_HPP
+#define POOL_BASE_HPP
+
+#include <iosfwd>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <typeindex>
+#include <typeinfo>
+#include <memory_resource>
+
+#include "entity.hpp"
+#include "signal.hpp"
+
+namespace ecs
+{
+    /**
+     * @brief The signal published by a pool when a component of an entity is constructed, updated or destroyed
+     * through the registry.
+     */
+    using component_signal = signal<registry &, entity const &>;
+
+    /**
+     * @brief This struct refers to the changes of a component since a given tick, as entity indexes (see
+     * registry::diff). An entity whose component was removed then added again is listed in removed and added.
+     */
+    struct component_changes
+    {
+        std::type_index type;
+
+        std::vector<std::size_t> added;
+
+        std::vector<std::size_t> changed;
+
+        std::vector<std::size_t> removed;
+    };
+
+    /**
+     * @brief This class refers to the type erased interface of the pool of a component, used by the registry for the
+     * operations that don't depend on the type of the component.
+     */
+    class pool_base
+    {
+        public:
+            pool_base() noexcept :
+                _onConstruct{},
+                _onUpdate{},
+                _onDestroy{}
+            {}
+
+            pool_base(pool_base const &other) = default;
+
+            pool_base(pool_base &&other) noexcept = default;
+
+            virtual ~pool_base() = default;
+
+            pool_base &operator=(pool_base const &other) = default;
+
+            pool_base &operator=(pool_base &&other) noexcept = default;
+
+            /**
+             * @brief This method removes the component of an entity. Does nothing if the entity does not own one.
+             * @param [in] e This parameter refers to the entity.
+             */
+            virtual void remove(entity const &e) = 0;
+
+            /**
+             * @brief This method removes the components of several entities, entities that don't own one are ignored.
+             * @param [in] entities This parameter refers to the entities.
+             * @param [in] count This parameter refers to the number of entities.
+             */
+            virtual void remove(entity const *entities, std::size_t count) = 0;
+
+            /**
+             * @brief This method checks whether an entity owns a component.
+             * @param [in] e This parameter refers to the entity.
+             */
+            [[nodiscard]] virtual bool contains(entity const &e) const noexcept = 0;
+
+            /**
+             * @brief This method returns the number of components stored in the pool.
+             */
+            [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+
+            /**
+             * @brief This method removes all components from the pool.
+             */
+            virtual void clear() = 0;
+
+            /**
+             * @brief This method reserves storage for a given number of components.
+             * @param [in] n This parameter refers to the number of components.
+             */
+            virtual void reserve(std::size_t n) = 0;
+
+            /**
+             * @brief This method returns a deep copy of the pool.
+             * @param [in] resource This parameter refers to the memory resource of the copy, used when the container
+             * allocates from a memory resource.
+             */
+            [[nodiscard]] virtual std::unique_ptr<pool_base> clone(std::pmr::memory_resource *resource) const = 0;
+
+            /**
+             * @brief This method replaces the components and the listeners of the pool with those of another pool of
+             * the same component, reusing the storage already allocated.
+             * @param [in] other This parameter refers to the pool to copy, it must store the same component.
+             */
+            virtual void copy_from(pool_base const &other) = 0;
+
+            /**
+             * @brief This method writes the components of the pool to a snapshot (see snapshot::save).
+             * @param [in] out This parameter refers to the stream to write to.
+             */
+            virtual void save(std::ostream &out) const = 0;
+
+            /**
+             * @brief This method replaces the components of the pool with the components read from a snapshot (see
+             * snapshot::load).
+             * @param [in] in This parameter refers to the stream to read from.
+             * @param [in] entities This parameter refers to the number of entity slots, components of entities with
+             * a higher index are rejected.
+             */
+            virtual void load(std::istream &in, std::size_t entities) = 0;
+
+            /**
+             * @brief This method sets the tick stamped on the changes of the pool (see registry::tick).
+             */
+            virtual void set_tick(std::uint64_t tick) noexcept = 0;
+
+            /**
+             * @brief This method enables or disables the tracking of the changes of the pool. Only a sparse_array
+             * tracks its changes: sparse_set, transient_set and soa_array don't (registry::track_changes rejects them
+             * at compile time).
+             * @throw If the container of the pool is not a sparse_array, the method throws an
+             * exceptions::changes_not_tracked_exception.
+             */
+            virtual void track_changes(bool enabled) = 0;
+
+            /**
+             * @brief This method checks whether the pool tracks its changes (see sparse_array::track_changes).
+             * collect_changes, discard_changes and save_changes do nothing on pools that don't.
+             */
+            [[nodiscard]] virtual bool tracks_changes() const noexcept = 0;
+
+            /**
+             * @brief This method appends the changes of the pool since a given tick.
+             * @param [in] since This parameter refers to the tick.
+             * @param [out] changes This parameter refers to the changes to append to.
+             */
+            virtual void collect_changes(std::uint64_t since, component_changes &changes) const = 0;
+
+            /**
+             * @brief This method forgets the removals stamped before a given tick.
+             */
+            virtual void discard_changes(std::uint64_t until) = 0;
+
+            /**
+             * @brief This method writes the changes of the pool since a given tick (see snapshot::save_changes).
+             */
+            virtual void save_changes(std::ostream &out, std::uint64_t since) const = 0;
+
+            /**
+             * @brief This method applies changes written by save_changes (see snapshot::load_changes). Changes can be
+             * applied whether the pool tracks its own changes or not.
+             * @param [in] in This parameter refers to the stream to read from.
+             * @param [in] entities This parameter refers to the number of entity slots (see load).
+             * @throw If the container of the pool is not a sparse_array, the method throws an
+             * exceptions::changes_not_tracked_exception.
+             */
+            virtual void load_changes(std::istream &in, std::size_t entities) = 0;
+
+            /**
+             * @brief This method returns the type of the component stored in the pool.
+             */
+            [[nodiscard]] virtual std::type_info const &type() const noexcept = 0;
+
+            /**
+             * @brief This method returns the signal published after a component is added to an entity that did not
+             * own one (see registry::on_construct).
+             */
+            [[nodiscard]] component_signal &on_construct() noexcept
+            {
+                return _onConstruct;
+            }
+
+            /**
+             * @brief This method returns the signal published after the component of an entity is replaced or patched
+             * (see registry::on_update).
+             */
+            [[nodiscard]] component_signal &on_update() noexcept
+            {
+                return _onUpdate;
+            }
+
+            /**
+             * @brief This method returns the signal published before the component of an entity is removed (see
+             * registry::on_destroy).
+             */
+            [[nodiscard]] component_signal &on_destroy() noexcept
+            {
+                return _onDestroy;
+            }
+
+        private:
+            component_signal _onConstruct;
+
+            component_signal _onUpdate;
+
+            component_signal _onDestroy;
+    };
+}
+
+#endif //POOL_BASE_HPP
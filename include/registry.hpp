@@ -1,17 +1,32 @@
 #ifndef REGISTRY_HPP
 #define REGISTRY_HPP
 
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <iterator>
 #include <vector>
-#include <any>
-#include <vector>
+#include <utility>
 #include <functional>
+#include <type_traits>
 #include <typeindex>
 #include <stdexcept>
+#include <memory_resource>
 #include <exceptions/component_already_registered_exception.hpp>
 
-#include "sparse_array.hpp"
+#include "batch.hpp"
+#include "command_buffer.hpp"
+#include "component_id.hpp"
+#include "component_pool.hpp"
+#include "component_storage.hpp"
 #include "entity.hpp"
+#include "entity_group.hpp"
+#include "entity_pool.hpp"
+#include "is_transient_set.hpp"
+#include "thread_pool.hpp"
 #include "exceptions/component_not_registered_exception.hpp"
+#include "exceptions/invalid_entity_exception.hpp"
 
 //TODO unregister systems and components from the registry
 
@@ -24,7 +39,45 @@ namespace ecs
     class registry
     {
         public:
-            registry() noexcept;
+            using tick_type = std::uint64_t;
+
+            registry();
+
+            /**
+             * @brief This constructor creates a registry whose component pools allocate from a memory resource. Only
+             * the components stored in a container allocating from a memory resource use it (see ecs::pmr), the
+             * others are allocated from the heap. The bookkeeping of the registry itself is always allocated from the
+             * heap: the entity slots, the table of pools, the systems, the groups, the command buffers and the scratch
+             * buffers of the zippers.
+             * @param [in] resource This parameter refers to the memory resource, it must outlive the registry and its
+             * copies.
+             */
+            explicit registry(std::pmr::memory_resource *resource);
+
+            /**
+             * @brief This constructor copies a registry, the components of the copy are allocated from the memory
+             * resource of other. The listeners of the component signals are copied with their pool.
+             */
+            registry(registry const &other);
+
+            registry(registry &&other) noexcept = default;
+
+            ~registry() = default;
+
+            registry &operator=(registry const &other);
+
+            registry &operator=(registry &&other) noexcept = default;
+
+            /**
+             * @brief This method replaces the entities, the components, the groups and the tick of the registry with
+             * those of another registry, reusing the storage already allocated: the pools registered in both are
+             * copied in place (see sparse_array::operator=), so restoring a copy of the registry taken earlier, as a
+             * rollback does every frame, allocates nothing when its shape did not change. Trivially copyable
+             * components are copied as raw pages. The systems, the concurrency and the memory resource of the registry
+             * are kept.
+             * @param [in] other This parameter refers to the registry to copy, for instance a copy of this registry.
+             */
+            void copy_from(registry const &other);
 
             /**
              * @brief This method creates an entity. When entity is about to get destroyed,
@@ -33,6 +86,20 @@ namespace ecs
              */
             entity spawn_entity() noexcept;
 
+            /**
+             * @brief This method creates several entities at once. When entities are about to get destroyed,
+             * kill_entity or kill_entities must be called.
+             * @tparam OutputIt This template refers to the type of the iterator receiving the entities.
+             * @param [in] n This parameter refers to the number of entities to create.
+             * @param [out] out This parameter refers to the iterator receiving the created entities.
+             * @return The iterator following the last entity written.
+             */
+            template <class OutputIt>
+            OutputIt spawn_entities(std::size_t n, OutputIt out)
+            {
+                return _entities.spawn_n(n, out);
+            }
+
             /**
              * @brief This method created an entity from the given index.
              * If you add components to this entity, you must kill it with kill_entity, otherwise, you got nothing to do
@@ -44,37 +111,95 @@ namespace ecs
             entity entity_from_index(std::size_t index);
 
             /**
-             * @brief This methods kills the given entity.
+             * @brief This method reserves an entity, spawned by the next flush_commands. Unlike spawn_entity it may be
+             * called by systems running concurrently: a system creating an entity reserves it then records its
+             * components in commands(). The entity is not valid until it is spawned.
+             * @return The reserved entity.
+             */
+            entity reserve_entity() noexcept;
+
+            /**
+             * @brief This method creates an entity for every index of a range, for instance to mirror a block of
+             * replicated entities. Either all entities are created or none.
+             * @tparam OutputIt This template refers to the type of the iterator receiving the entities.
+             * @param [in] first This parameter refers to the first index to be used to create entities.
+             * @param [in] last This parameter refers to the index following the last index to be used.
+             * @param [out] out This parameter refers to the iterator receiving the created entities, in index order.
+             * @return The iterator following the last entity written.
+             * @throw May throw a runtime_error "entity already spawned." if an index of the range is an already spawned
+             * entity.
+             */
+            template <class OutputIt>
+            OutputIt entities_from_range(std::size_t first, std::size_t last, OutputIt out)
+            {
+                return _entities.spawn_range(first, last, out);
+            }
+
+            /**
+             * @brief This methods kills the given entity. Does nothing if the entity is not alive. on_destroy is
+             * published for each of its components before they are removed.
              * @param [in] e This parameter refers to the entity to kill.
              */
             void kill_entity(entity const &e) noexcept;
 
             /**
-             * @brief This method adds a component to the given entity.
+             * @brief This methods kills several entities. Their components are removed in a single pass over each
+             * pool. Entities that are not alive are ignored.
+             * @tparam Entities This template refers to the type of the range of entities, it must be a forward range.
+             * @param [in] entities This parameter refers to the entities to kill.
+             */
+            template <class Entities>
+            void kill_entities(Entities const &entities)
+            {
+                std::vector<entity> killed;
+
+                killed.reserve(static_cast<std::size_t>(std::distance(std::begin(entities), std::end(entities))));
+                for (auto const &e : entities)
+                    if (_entities.kill(e))
+                        killed.push_back(e);
+                _erase_entities(killed.data(), killed.size());
+            }
+
+            /**
+             * @brief This method checks whether an entity is alive. A handle kept after its entity was killed is never
+             * valid, even once its index has been recycled by another entity.
+             * @param [in] e This parameter refers to the entity to check.
+             */
+            [[nodiscard]] bool valid(entity const &e) const noexcept;
+
+            /**
+             * @brief This method adds a component to the given entity. on_construct is published if the entity did not
+             * own the component, on_update otherwise.
              * @tparam Component This template refers to the component to add to the entity.
              * @param [in] entity This parameter refers to the entity to add the component to.
              * @param [in] value This parameter refers to the value to assign to the component using move.
              * @return A reference to the component contained in the sparse_array.
              * @throw If The component is not registered inside the registry,
-             * the method will throw a component_not_registered_exception.
+             * the method will throw a component_not_registered_exception. If the entity is not alive, it throws an
+             * invalid_entity_exception.
              */
             template <typename Component>
-            typename containers::sparse_array<Component>::reference_type add_component(
+            typename component_storage_t<Component>::reference_type add_component(
                 entity const &entity,
                 Component &&value)
             {
-                try {
-                    auto &res = _components.at(std::type_index(typeid(Component)));
-                    auto &arr = std::any_cast<containers::sparse_array<Component> &>(res.first);
+                auto &pool = _get_pool<Component>();
+                auto &storage = static_cast<pool_t<Component> &>(pool).storage();
 
-                    return arr.insert_at(entity, std::forward<Component>(value));
-                } catch (std::out_of_range &) {
-                    throw _generate_component_not_registered<Component>();
-                }
+                _entities.check(entity);
+                if (pool.on_construct().empty() && pool.on_update().empty())
+                    return storage.insert_at(entity, std::forward<Component>(value));
+
+                const bool update = storage.contains(entity);
+
+                storage.insert_at(entity, std::forward<Component>(value));
+                _publish_insert(pool, update, entity);
+                return storage[entity];
             }
 
             /**
-             * @brief This method constructs a component and adds it to the given entity.
+             * @brief This method constructs a component and adds it to the given entity. on_construct is published if
+             * the entity did not own the component, on_update otherwise.
              * @tparam Component This template refers to the component to emplace to the entity.
              * @tparam Params This variadic template refers to the type of the parameters to pass to the component's
              * constructor.
@@ -82,25 +207,112 @@ namespace ecs
              * @param [in] p This parameter refers to the value of the parameters to pass to the component's constructor.
              * @return A reference to the component contained in the sparse_array.
              * @throw If the component is not registered into the registry, the function will throw a
-             * component_not_registered_exception
+             * component_not_registered_exception. If the entity is not alive, it throws an invalid_entity_exception.
              */
             template <typename Component, typename ... Params>
-            typename containers::sparse_array<Component>::reference_type emplace_component(
+            typename component_storage_t<Component>::reference_type emplace_component(
                 entity const &entity,
                 Params &&... p)
             {
-                try {
-                    auto &res = _components.at(std::type_index(typeid(Component)));
-                    auto &arr = std::any_cast<containers::sparse_array<Component> &>(res.first);
+                auto &pool = _get_pool<Component>();
+                auto &storage = static_cast<pool_t<Component> &>(pool).storage();
 
-                    return arr.emplace_at(entity, std::forward<Params>(p)...);
-                } catch (std::out_of_range &) {
-                    throw _generate_component_not_registered<Component>();
+                _entities.check(entity);
+                if (pool.on_construct().empty() && pool.on_update().empty())
+                    return storage.emplace_at(entity, std::forward<Params>(p)...);
+
+                const bool update = storage.contains(entity);
+
+                storage.emplace_at(entity, std::forward<Params>(p)...);
+                _publish_insert(pool, update, entity);
+                return storage[entity];
+            }
+
+            /**
+             * @brief This method adds a component to several entities. The pool is grown once for all the entities
+             * when no listener is connected to on_construct nor on_update, otherwise the components are added one by
+             * one and the signals are published for each entity.
+             * @tparam Component This template refers to the component to add to the entities.
+             * @tparam Entities This template refers to the type of the range of entities, it must be a forward range.
+             * @tparam Values This template refers to the type of the range of values.
+             * @param [in] entities This parameter refers to the entities to add the component to.
+             * @param [in] values This parameter refers to the values to assign to the components, one per entity. The
+             * values are moved if the range is an rvalue.
+             * @throw If the component is not registered into the registry, the function will throw a
+             * component_not_registered_exception. If an entity is not alive, it throws an invalid_entity_exception
+             * and no component is added.
+             */
+            template <typename Component, class Entities, class Values>
+            void insert_range(Entities const &entities, Values &&values)
+            {
+                auto &pool = _get_pool<Component>();
+                auto &storage = static_cast<pool_t<Component> &>(pool).storage();
+
+                for (auto const &e : entities)
+                    _entities.check(e);
+                if (pool.on_construct().empty() && pool.on_update().empty()) {
+                    if constexpr (std::is_rvalue_reference_v<Values &&>)
+                        storage.insert_range(
+                            std::begin(entities),
+                            std::end(entities),
+                            std::make_move_iterator(std::begin(values))
+                        );
+                    else
+                        storage.insert_range(std::begin(entities), std::end(entities), std::begin(values));
+                    return;
+                }
+
+                auto value = std::begin(values);
+
+                for (auto const &e : entities) {
+                    const bool update = storage.contains(e);
+
+                    if constexpr (std::is_rvalue_reference_v<Values &&>)
+                        storage.insert_at(e, std::move(*value));
+                    else
+                        storage.insert_at(e, *value);
+                    ++value;
+                    _publish_insert(pool, update, e);
                 }
             }
 
             /**
-             * @brief This method removes a component from an entity.
+             * @brief This method constructs a component for several entities from the same parameters. The pool is
+             * grown once for all the entities when no listener is connected to on_construct nor on_update, otherwise
+             * the components are constructed one by one and the signals are published for each entity.
+             * @tparam Component This template refers to the component to emplace to the entities.
+             * @tparam Entities This template refers to the type of the range of entities, it must be a forward range.
+             * @tparam Params This variadic template refers to the type of the parameters to pass to the component's
+             * constructor.
+             * @param [in] entities This parameter refers to the entities to add the component to.
+             * @param [in] p This parameter refers to the parameters to pass to every constructor.
+             * @throw If the component is not registered into the registry, the function will throw a
+             * component_not_registered_exception. If an entity is not alive, it throws an invalid_entity_exception
+             * and no component is added.
+             */
+            template <typename Component, class Entities, typename ... Params>
+            void emplace_n(Entities const &entities, Params const &... p)
+            {
+                auto &pool = _get_pool<Component>();
+                auto &storage = static_cast<pool_t<Component> &>(pool).storage();
+
+                for (auto const &e : entities)
+                    _entities.check(e);
+                if (pool.on_construct().empty() && pool.on_update().empty()) {
+                    storage.emplace_n(std::begin(entities), std::end(entities), p...);
+                    return;
+                }
+                for (auto const &e : entities) {
+                    const bool update = storage.contains(e);
+
+                    storage.emplace_at(e, p...);
+                    _publish_insert(pool, update, e);
+                }
+            }
+
+            /**
+             * @brief This method removes a component from an entity. on_destroy is published first if the entity owns
+             * the component. Does nothing if the entity is not alive, its components were removed when it was killed.
              * @tparam Component This template refers to the component to remove from the entity.
              * @param [in] entity This parameter refers to the entity to remove the component from.
              * @throw If the component is not registered into the registry, the function will throw a
@@ -109,38 +321,118 @@ namespace ecs
             template <typename Component>
             void remove_component(entity const &entity)
             {
-                try {
-                    auto res = _components.at(std::type_index(typeid(Component)));
+                auto &pool = _get_pool<Component>();
+                auto &storage = static_cast<pool_t<Component> &>(pool).storage();
+
+                if (!_entities.valid(entity))
+                    return;
+                if (!pool.on_destroy().empty() && storage.contains(entity))
+                    pool.on_destroy().publish(*this, entity);
+                storage.erase(entity);
+            }
 
-                    res.second(*this, entity);
-                } catch (std::out_of_range &) {
-                    throw _generate_component_not_registered<Component>();
-                }
+            /**
+             * @brief This method modifies the component of an entity in place then publishes on_update. Components
+             * modified through get_component or by a system don't publish it.
+             * @tparam Component This template refers to the component to modify.
+             * @tparam Function This template refers to the type of the function, called as f(component).
+             * @param [in] entity This parameter refers to the entity owning the component.
+             * @param [in] f This parameter refers to the function modifying the component, passed a soa_reference
+             * when the component is stored in a soa_array.
+             * @return A reference to the component.
+             * @throw If the component is not registered into the registry, the function will throw a
+             * component_not_registered_exception. If the entity is not alive, it throws an invalid_entity_exception,
+             * and if it does not own the component an std::out_of_range.
+             */
+            template <typename Component, typename Function>
+            decltype(auto) patch(entity const &entity, Function &&f)
+            {
+                auto &pool = _get_pool<Component>();
+                auto &storage = static_cast<pool_t<Component> &>(pool).storage();
+
+                _entities.check(entity);
+                if (!storage.contains(entity))
+                    throw std::out_of_range("Component not found");
+                std::forward<Function>(f)(storage.get(entity));
+                if (!pool.on_update().empty())
+                    pool.on_update().publish(*this, entity);
+                return storage.get(entity);
+            }
+
+            /**
+             * @brief This method returns the signal published after a component is added to an entity that did not
+             * own one, by add_component, emplace_component, insert_range or emplace_n. Listeners are called as
+             * f(registry, entity) and may read the component. Maintaining an index from it avoids scanning the
+             * entities every frame; with no listener connected, the registry only checks that the signal is empty.
+             * @warning Listeners run on the thread modifying the registry, possibly a system running concurrently
+             * (see set_concurrency): they must only access the components of that system. They must not remove the
+             * component they are notified for.
+             * @tparam Component This template refers to the component.
+             * @throw If the component is not registered into the registry, the function will throw a
+             * component_not_registered_exception.
+             */
+            template <class Component>
+            [[nodiscard]] component_signal &on_construct()
+            {
+                return _get_pool<Component>().on_construct();
+            }
+
+            /**
+             * @brief This method returns the signal published after the component of an entity is replaced by
+             * add_component, emplace_component, insert_range or emplace_n, or modified by patch. Listeners are called
+             * as in on_construct.
+             * @tparam Component This template refers to the component.
+             * @throw If the component is not registered into the registry, the function will throw a
+             * component_not_registered_exception.
+             */
+            template <class Component>
+            [[nodiscard]] component_signal &on_update()
+            {
+                return _get_pool<Component>().on_update();
+            }
+
+            /**
+             * @brief This method returns the signal published before the component of an entity is removed by
+             * remove_component, kill_entity or kill_entities. Listeners are called as in on_construct, the component is
+             * still stored. When the entity is killed it is already invalid (see valid), and listeners must not throw.
+             * Clearing pools (load, transient_set at the end of run_systems) does not publish it.
+             * @tparam Component This template refers to the component.
+             * @throw If the component is not registered into the registry, the function will throw a
+             * component_not_registered_exception.
+             */
+            template <class Component>
+            [[nodiscard]] component_signal &on_destroy()
+            {
+                return _get_pool<Component>().on_destroy();
             }
 
             /**
-             * @brief This method registers a component into the registry.
+             * @brief This method registers a component into the registry. The container used to store the component
+             * is selected by the component_storage struct (sparse_array by default).
              * @tparam Component This template refers to the component to register into the registry
-             * @return A reference to the sparse_array of components.
+             * @return A reference to the container of components.
              * @throw todo, then
              */
             template <class Component>
-            containers::sparse_array<Component> &register_component()
+            component_storage_t<Component> &register_component()
             {
-                 auto [it, res] = _components.try_emplace(
-                    std::type_index(std::type_index(typeid(Component))),
-                    containers::sparse_array<Component>(),
-                    [](registry &r, entity const &other) {
-                        auto &component = r.get_component<Component>();
-
-                        if (component.size() > other)
-                            component[other] = std::nullopt;
-                    }
-                );
+                const std::size_t id = component_id::get<Component>();
 
-                if (!res)
+                if (id < _components.size() && _components[id])
                     throw _generate_component_already_registered<Component>();
-                return std::any_cast<containers::sparse_array<Component> &>(it->second.first);
+                if (id >= _components.size())
+                    _components.resize(id + 1);
+
+                auto pool = std::make_unique<pool_t<Component>>(_resource);
+                auto &storage = pool->storage();
+
+                pool->set_tick(_tick);
+
+                if constexpr (assertion::is_transient_set_v<component_storage_t<Component>>)
+                    _transients.push_back(id);
+
+                _components[id] = std::move(pool);
+                return storage;
             }
 
             /**
@@ -151,15 +443,9 @@ namespace ecs
              * component_not_registered_exception
              */
             template <class Component>
-            [[nodiscard]] containers::sparse_array<Component> &get_component()
+            [[nodiscard]] component_storage_t<Component> &get_component()
             {
-                try {
-                    auto &component = _components.at(std::type_index(typeid(Component)));
-
-                    return std::any_cast<containers::sparse_array<Component> &>(component.first);
-                } catch (std::out_of_range &) {
-                    throw _generate_component_not_registered<Component>();
-                }
+                return static_cast<pool_t<Component> &>(_get_pool<Component>()).storage();
             }
 
             /**
@@ -170,71 +456,367 @@ namespace ecs
              * component_not_registered_exception
              */
             template <class Component>
-            [[nodiscard]] containers::sparse_array<Component> const &get_component() const
+            [[nodiscard]] component_storage_t<Component> const &get_component() const
             {
-                try {
-                    auto const &component = _components.at(std::type_index(typeid(Component)));
+                return static_cast<pool_t<Component> const &>(_get_pool<Component>()).storage();
+            }
 
-                    return std::any_cast<containers::sparse_array<Component> &>(component.first);
-                } catch (std::out_of_range &) {
-                    throw _generate_component_not_registered<Component>();
-                }
+            /**
+             * @brief This method calls a function for every run of consecutive entities owning all the given
+             * components, with a view over the components of the run per component (see containers::each_batch).
+             * Systems walking the views with plain loops skip the per-entity work of the zippers, and the compiler
+             * vectorizes the loops over the fields of components stored in a soa_array.
+             * @tparam Components This variadic template refers to the components, stored in a sparse_array or a
+             * soa_array. A const component gives a read-only view.
+             * @tparam Function This template refers to the type of the function, called as f(first, count, views...)
+             * where first is the index of the first entity of the run and count its length.
+             * @param [in] f This parameter refers to the function to call.
+             * @throw If a component is not registered into the registry, the function will throw a
+             * component_not_registered_exception.
+             */
+            template <class ... Components, class Function>
+            void each_batch(Function &&f)
+            {
+                containers::each_batch(std::forward<Function>(f), _system_argument<Components>()...);
+            }
+
+            /**
+             * @brief This method returns the group of the entities owning all the given components. The group is built
+             * by scanning the components the first time it is requested, then kept up to date as components are added
+             * and removed through the registry, load and load_changes: systems iterating over it every frame don't
+             * rediscover the matching entities. Keeping it up to date connects listeners to on_construct and
+             * on_destroy, so adding and removing these components is slightly slower once a group uses them.
+             * @tparam Components This variadic template refers to the components of the group, a const component is
+             * passed as a const reference by entity_group::each. Groups with the same components in another order
+             * are distinct groups.
+             * @return A reference to the group, valid until the registry is destroyed.
+             * @throw If a component is not registered into the registry, the function will throw a
+             * component_not_registered_exception.
+             */
+            template <class ... Components>
+            entity_group<Components...> &group()
+            {
+                using group_type = entity_group<Components...>;
+
+                for (auto &g : _groups)
+                    if (g->type() == typeid(group_type))
+                        return static_cast<group_type &>(*g);
+                (static_cast<void>(_get_pool<Components>()), ...);
+
+                auto g = std::make_unique<group_type>(_components);
+                auto &result = *g;
+                const std::size_t index = _groups.size();
+
+                g->rebuild(_entities);
+                _groups.push_back(std::move(g));
+                (_connect_group<Components>(index), ...);
+                return result;
+            }
+
+            /**
+             * @brief This method enables or disables the tracking of the changes of a component, listed by diff and
+             * written by save_changes (see sparse_array::track_changes).
+             * @tparam Component This template refers to the component, it must be stored in a sparse_array.
+             * @param [in] enabled This parameter refers to whether changes are tracked.
+             * @throw If the component is not registered into the registry, the function will throw a
+             * component_not_registered_exception.
+             */
+            template <class Component>
+            void track_changes(bool enabled = true)
+            {
+                static_assert(
+                    assertion::is_sparse_array_v<component_storage_t<Component>>,
+                    "Only the components stored in a sparse_array can track their changes."
+                );
+                _get_pool<Component>().track_changes(enabled);
             }
 
             /**
              * @brief This method registers a system into the registry by moving it.
-             * @tparam Components This variadic template refers to the components to be used by the system.
+             * @tparam Components This variadic template refers to the components to be used by the system. A const
+             * qualified component is passed to the system as a const reference and marks the system as a reader of
+             * this component, allowing systems that only read it to run concurrently.
              * @tparam Function This template refers to the type of the system (it MUST implement the () operator).
              * @param [in] f This parameter refers to an rvalue reference to the system.
              */
             template <class ... Components, typename Function>
             void add_system(Function &&f) noexcept
             {
-                _systems.emplace_back([f = std::forward<Function>(f)](registry &r, double deltaTime) {
-                    f(r, deltaTime, r.get_component<Components>()...);
+                _add_system<Components...>([f = std::forward<Function>(f)](registry &r, double deltaTime) {
+                    f(r, deltaTime, r._system_argument<Components>()...);
                 });
             }
 
             /**
              * @brief This method registers a system into the registry by copying the target of the reference.
-             * @tparam Components This variadic template refers to the components to be used by the system.
+             * @tparam Components This variadic template refers to the components to be used by the system. A const
+             * qualified component is passed to the system as a const reference and marks the system as a reader of
+             * this component, allowing systems that only read it to run concurrently.
              * @tparam Function This template refers to the type of the system (it MUST implement the () operator).
              * @param [in] f This parameter refers to an reference to the system.
              */
             template <class ... Components , typename Function>
             void add_system(Function const &f) noexcept
             {
-                _systems.emplace_back([f](registry &r, double deltaTime) {
-                    f(r, deltaTime, r.get_component<Components>()...);
+                _add_system<Components...>([f](registry &r, double deltaTime) {
+                    f(r, deltaTime, r._system_argument<Components>()...);
                 });
             }
 
             /**
-             * @brief This method runs all systems registered into the registry.
+             * @brief This method runs all systems registered into the registry. When the registry has worker threads
+             * (see set_concurrency), systems that don't conflict run concurrently: two systems conflict when they
+             * share a component and at least one of them does not access it as const. Conflicting systems run in
+             * the order they were added, so the results are the same as a serial run. Systems declaring no
+             * component conflict with every other system. Once every system has run, the components stored in a
+             * transient_set are cleared, the commands recorded are applied (see flush_commands) and the tick is
+             * incremented.
+             * @warning When running concurrently, a system must only access the components it declares and must not
+             * spawn nor kill entities: it records them in commands() instead, and reserves the entities it creates
+             * with reserve_entity.
+             * @throw Rethrows the first exception thrown by a system, once all the running systems are done.
              */
             void run_systems(double deltaTime);
 
+            /**
+             * @brief This method sets the number of worker threads used by run_systems.
+             * @param [in] threads This parameter refers to the number of worker threads. 0 or 1 runs systems serially
+             * on the calling thread.
+             */
+            void set_concurrency(std::size_t threads);
+
+            /**
+             * @brief This method returns the worker threads of the registry, or nullptr if systems run serially.
+             */
+            [[nodiscard]] thread_pool *workers() const noexcept;
+
+            /**
+             * @brief This method returns the command buffer of the calling thread, to record the structural changes a
+             * system cannot make while iterating over the pools (adding or removing components, killing entities).
+             * Each worker thread records into its own buffer without locking, threads that are not workers of the
+             * registry share one buffer and must not record concurrently. The commands are applied by
+             * flush_commands, which run_systems calls once every system has run.
+             * @code
+             * registry.add_system<emitter const>([](ecs::registry &r, double, auto const &emitters) {
+             *     for (auto &&[e] : ecs::containers::zipper(emitters))
+             *         r.commands().add(r.reserve_entity(), particle{ e.x, e.y });
+             * });
+             * @endcode
+             */
+            [[nodiscard]] command_buffer &commands();
+
+            /**
+             * @brief This method spawns the entities reserved by reserve_entity then plays back the command buffers
+             * of every thread, in thread order (see command_buffer::play). Each buffer applies its commands in
+             * entity index order a block at a time, inserting the components added to a block with a single
+             * insert_range. Signals are published as for add_component, remove_component and kill_entities.
+             * @warning It must not be called while systems are running.
+             * @throw If a commanded component is not registered, the method throws a
+             * component_not_registered_exception. The commands of the buffers played after are kept.
+             */
+            void flush_commands();
+
+            /**
+             * @brief This method writes a binary snapshot of the entities and of the components of every registered
+             * component (see the snapshot namespace for the format). Components are identified by the name of their
+             * type: a snapshot is meant to be loaded by the program that wrote it.
+             * @param [in] out This parameter refers to the stream to write to, opened in binary mode.
+             * @throw If a registered component is not serializable (see snapshot::is_serializable_v), or if the stream
+             * fails, the method throws an exceptions::snapshot_exception.
+             */
+            void save(std::ostream &out) const;
+
+            /**
+             * @brief This method replaces the entities and the components of the registry with the ones of a snapshot
+             * written by save. Every component of the snapshot must be registered, registered components missing from
+             * the snapshot are cleared. Systems are kept.
+             * @param [in] in This parameter refers to the stream to read from, opened in binary mode.
+             * @throw If the snapshot is truncated, corrupted or holds a component that is not registered, the method
+             * throws an exceptions::snapshot_exception and the registry is left without entities nor components.
+             */
+            void load(std::istream &in);
+
+            /**
+             * @brief This method returns the current tick of the registry. The changes made to the components tracking
+             * them (see track_changes) are stamped with the tick they are made at, run_systems increments it.
+             */
+            [[nodiscard]] tick_type tick() const noexcept;
+
+            /**
+             * @brief This method lists the components added, changed (inserted again or accessed through a non const
+             * accessor) and removed since a given tick, for every component tracking its changes. Unchanged
+             * pages are skipped, the cost scales with the number of changes rather than with the number of entities.
+             * Pass the tick() read when the previous changes were consumed: changes made after it, during the same
+             * tick, are listed again rather than lost.
+             * @param [in] since This parameter refers to the tick, changes stamped with it are included.
+             * @return The changes of every component that changed.
+             */
+            [[nodiscard]] std::vector<component_changes> diff(tick_type since) const;
+
+            /**
+             * @brief This method forgets the removals stamped before a given tick, once every consumer of the changes
+             * (e.g. every client) is past it. Removals are kept until then.
+             * @param [in] until This parameter refers to the tick.
+             */
+            void discard_changes(tick_type until);
+
+            /**
+             * @brief This method writes a delta snapshot: the changes made since a given tick to the components tracking
+             * them, in the format of snapshot::save_changes. Entities are not written, their lifetime is
+             * replicated separately (e.g. by a full snapshot).
+             * @param [in] out This parameter refers to the stream to write to, opened in binary mode.
+             * @param [in] since This parameter refers to the tick (see diff).
+             * @throw If a changed component is not serializable (see snapshot::is_serializable_v), or if the stream
+             * fails, the method throws an exceptions::snapshot_exception.
+             */
+            void save_changes(std::ostream &out, tick_type since) const;
+
+            /**
+             * @brief This method applies a delta snapshot written by save_changes. Every component of the delta must be
+             * registered and stored in a sparse_array, it does not need to track its own changes. The entities the
+             * delta refers to must have been replicated first: components of entities whose index was never spawned
+             * are rejected.
+             * @param [in] in This parameter refers to the stream to read from, opened in binary mode.
+             * @throw If the delta is truncated, corrupted or holds a component that is not registered, the method
+             * throws an exceptions::snapshot_exception. If it holds a component that is not stored in a sparse_array,
+             * the method throws an exceptions::changes_not_tracked_exception. The changes of the components read
+             * before the error are kept.
+             */
+            void load_changes(std::istream &in);
+
         private:
-            using entity_eraser = std::function<void (registry &, entity const &)>;
+            static constexpr char _snapshot_magic[4] = { 'E', 'C', 'S', 'S' };
+
+            static constexpr std::uint32_t _snapshot_version = 1;
+
+            static constexpr char _delta_magic[4] = { 'E', 'C', 'S', 'D' };
+
+            template <class Component>
+            using pool_t = component_pool<component_storage_t<Component>>;
 
-            std::unordered_map<
-                std::type_index,
-                std::pair<std::any, entity_eraser>
-            > _components;
+            /**
+             * @brief Pools of the registered components, indexed by component_id.
+             */
+            std::vector<std::unique_ptr<pool_base>> _components;
 
-            std::vector<std::function<void (registry &r, double deltaTime)>> _systems;
+            std::pmr::memory_resource *_resource;
 
-            std::size_t _spawnedEntities;
+            /**
+             * @brief Ids of the components stored in a transient_set, cleared at the end of run_systems.
+             */
+            std::vector<std::size_t> _transients;
 
-            std::vector<std::size_t> _freedEntities{};
+            /**
+             * @brief Groups requested by group(), the listeners keeping them up to date refer to them by index.
+             */
+            std::vector<std::unique_ptr<group_base>> _groups;
+
+            tick_type _tick;
+
+            /**
+             * @brief A registered system and the components it accesses, as (component id, mutable access) pairs.
+             */
+            struct system
+            {
+                std::function<void (registry &r, double deltaTime)> run;
+
+                std::vector<std::pair<std::size_t, bool>> access;
+            };
+
+            std::vector<system> _systems;
+
+            /**
+             * @brief For each system, the index of the systems that must wait for it to complete.
+             */
+            std::vector<std::vector<std::size_t>> _dependents;
+
+            /**
+             * @brief For each system, the number of systems it must wait for.
+             */
+            std::vector<std::size_t> _dependencies;
+
+            bool _scheduled;
+
+            std::shared_ptr<thread_pool> _workers;
+
+            /**
+             * @brief Command buffer of each worker thread, followed by the buffer of the other threads.
+             */
+            std::vector<command_buffer> _commands;
+
+            entity_pool _entities;
+
+            template <class ... Components, typename Function>
+            void _add_system(Function &&f) noexcept
+            {
+                _systems.push_back({
+                    std::forward<Function>(f),
+                    { { component_id::get<Components>(), !std::is_const_v<Components> }... }
+                });
+                _scheduled = false;
+            }
+
+            template <class Component>
+            [[nodiscard]] auto &_system_argument()
+            {
+                if constexpr (std::is_const_v<Component>)
+                    return std::as_const(*this).template get_component<std::remove_const_t<Component>>();
+                else
+                    return get_component<Component>();
+            }
+
+            void _erase_entities(entity const *entities, std::size_t count) noexcept;
+
+            void _publish_insert(pool_base &pool, bool update, entity const &e)
+            {
+                if (update)
+                    pool.on_update().publish(*this, e);
+                else
+                    pool.on_construct().publish(*this, e);
+            }
+
+            template <class Component>
+            void _connect_group(std::size_t index)
+            {
+                auto &pool = _get_pool<Component>();
+
+                pool.on_construct().connect([index](registry &r, entity const &e) {
+                    r._groups[index]->refresh(e);
+                });
+                pool.on_destroy().connect([index](registry &r, entity const &e) {
+                    r._groups[index]->erase(e);
+                });
+            }
+
+            void _rebuild_groups();
+
+            /**
+             * @brief Returns the id of the pool storing the component of the given type name, or _components.size().
+             */
+            [[nodiscard]] std::size_t _find_pool(std::string const &name) const noexcept;
+
+            void _schedule();
+
+            void _run_concurrently(double deltaTime);
+
+            template <class Component>
+            [[nodiscard]] pool_base &_get_pool() const
+            {
+                const std::size_t id = component_id::get<Component>();
+
+                if (id >= _components.size() || !_components[id])
+                    throw _generate_component_not_registered<Component>();
+                return *_components[id];
+            }
 
             template <class Component>
             [[nodiscard]] exceptions::component_not_registered_exception _generate_component_not_registered() const
             {
                 std::vector<std::type_index> indexes;
 
-                for (auto const &e : _components)
-                    indexes.emplace_back(e.first);
+                for (auto const &pool : _components)
+                    if (pool)
+                        indexes.emplace_back(pool->type());
                 return {
                     typeid(Component),
                     indexes
@@ -246,8 +828,9 @@ namespace ecs
             {
                 std::vector<std::type_index> indexes;
 
-                for (auto const &e : _components)
-                    indexes.emplace_back(e.first);
+                for (auto const &pool : _components)
+                    if (pool)
+                        indexes.emplace_back(pool->type());
                 return {
                     typeid(Component),
                     indexes
@@ -255,6 +838,36 @@ namespace ecs
             }
 
     };
+
+    template <class Component>
+    void command_buffer::component_queue<Component>::play(registry &r)
+    {
+        const auto insert = [this, &r]() {
+            if (!inserted.empty())
+                r.template insert_range<Component>(inserted, std::move(values));
+            inserted.clear();
+            values.clear();
+        };
+
+        inserted.clear();
+        values.clear();
+        for (auto &block : blocks) {
+            for (auto &c : block) {
+                if (!r.valid(c.target))
+                    continue;
+                if (c.value) {
+                    inserted.push_back(c.target);
+                    values.push_back(std::move(*c.value));
+                } else {
+                    insert();
+                    r.template remove_component<Component>(c.target);
+                }
+            }
+            insert();
+            block.clear();
+        }
+        count = 0;
+    }
 }
 
 #endif //REGISTRY_HPP
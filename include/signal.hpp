@@ -0,0 +1,85 @@
+#ifndef SIGNAL_HPP
+#define SIGNAL_HPP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace ecs
+{
+    /**
+     * @brief This class refers to a list of listeners called in connection order when the signal is published.
+     * Publishing a signal without listeners only checks that the list is empty, so the callers check empty() to skip
+     * the work of preparing the arguments.
+     * @warning Listeners must not connect nor disconnect listeners of the signal publishing them.
+     * @tparam Args This variadic template refers to the type of the parameters passed to the listeners.
+     */
+    template<class ... Args>
+    class signal
+    {
+        public:
+            using listener = std::function<void (Args...)>;
+
+            using connection = std::size_t;
+
+            signal() noexcept :
+                _listeners{},
+                _next(0)
+            {}
+
+            /**
+             * @brief This method adds a listener to the signal.
+             * @tparam Function This template refers to the type of the listener, callable as f(args...).
+             * @param [in] f This parameter refers to the listener.
+             * @return The connection of the listener, to pass to disconnect.
+             */
+            template<class Function>
+            connection connect(Function &&f)
+            {
+                _listeners.emplace_back(_next, listener(std::forward<Function>(f)));
+                return (_next++);
+            }
+
+            /**
+             * @brief This method removes a listener from the signal.
+             * @param [in] c This parameter refers to the connection returned by connect.
+             * @return True if the listener was connected.
+             */
+            bool disconnect(connection c) noexcept
+            {
+                auto const it = std::find_if(_listeners.begin(), _listeners.end(), [c](auto const &l) {
+                    return l.first == c;
+                });
+
+                if (it == _listeners.end())
+                    return false;
+                _listeners.erase(it);
+                return true;
+            }
+
+            /**
+             * @brief This method checks whether the signal has no listener.
+             */
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return _listeners.empty();
+            }
+
+            /**
+             * @brief This method calls every listener with the given arguments.
+             */
+            void publish(Args ... args) const
+            {
+                for (auto const &l : _listeners)
+                    l.second(args...);
+            }
+
+        private:
+            std::vector<std::pair<connection, listener>> _listeners;
+
+            connection _next;
+    };
+}
+
+#endif //SIGNAL_HPP
@@ -0,0 +1,329 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <typeinfo>
+#include <algorithm>
+#include <type_traits>
+
+#include "is_soa_array.hpp"
+#include "exceptions/snapshot_exception.hpp"
+
+/**
+ * @brief Binary snapshots of the containers of a registry (see registry::save and registry::load). A container is
+ * written as the number of components, the block of the indexes of the entities owning them and the components.
+ * Trivially copyable components are written as a raw block, other components are written by their codec. Snapshots
+ * use the native byte order and layout: they are meant to be loaded by the program that wrote them, on the same
+ * architecture. Delta snapshots hold the changes of the containers tracking them (sparse_array) since a given tick.
+ */
+namespace ecs::snapshot
+{
+    /**
+     * @brief The codec struct writes and reads a component that is not trivially copyable and default constructible,
+     * or that must not be copied as raw bytes (owning pointers...). Specialize it to make a component serializable:
+     * @code
+     * template<>
+     * struct ecs::snapshot::codec<name>
+     * {
+     *     static void write(std::ostream &out, name const &n);
+     *
+     *     static name read(std::istream &in);
+     * };
+     * @endcode
+     * @tparam Component This template parameter refers to the component to serialize.
+     */
+    template<class Component>
+    struct codec {};
+
+    template<class Component, class = void>
+    struct has_codec : std::false_type {};
+
+    template<class Component>
+    struct has_codec<Component, std::void_t<
+        decltype(codec<Component>::write(std::declval<std::ostream &>(), std::declval<Component const &>())),
+        decltype(codec<Component>::read(std::declval<std::istream &>()))
+    >> : std::true_type {};
+
+    template<class Component>
+    constexpr inline bool has_codec_v = has_codec<Component>::value;
+
+    /**
+     * @brief True when a component can be written to a snapshot: it has a codec, or it is trivially copyable and
+     * default constructible so that its bytes can be read into a constructed component.
+     */
+    template<class Component>
+    constexpr inline bool is_serializable_v = has_codec_v<Component> ||
+        (std::is_trivially_copyable_v<Component> && std::is_default_constructible_v<Component>);
+
+    /**
+     * @brief Number of components moved at once between the stream and the containers.
+     */
+    static constexpr std::size_t chunk_size = 4096;
+
+    /**
+     * @brief This function writes a block of trivially copyable values.
+     * @throw If the stream fails, the function throws an exceptions::snapshot_exception.
+     */
+    template<class T>
+    void write_block(std::ostream &out, T const *data, std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as bytes.");
+
+        out.write(reinterpret_cast<char const *>(data), static_cast<std::streamsize>(count * sizeof(T)));
+        if (!out)
+            throw exceptions::snapshot_exception("failed to write the snapshot");
+    }
+
+    /**
+     * @brief This function reads a block of trivially copyable values.
+     * @throw If the stream ends before the block, the function throws an exceptions::snapshot_exception.
+     */
+    template<class T>
+    void read_block(std::istream &in, T *data, std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as bytes.");
+
+        in.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(count * sizeof(T)));
+        if (!in)
+            throw exceptions::snapshot_exception("unexpected end of the snapshot");
+    }
+
+    /**
+     * @brief This function appends a block of trivially copyable values to a vector. The block is read by chunks and
+     * the vector only grows as the values arrive, so that a corrupted count fails on the end of the stream instead of
+     * allocating it all at once.
+     * @param [in] count This parameter refers to the number of values, as read from the stream.
+     * @param [in] fill This parameter refers to the value the vector is grown with before a chunk is read.
+     * @throw If the stream ends before the block, the function throws an exceptions::snapshot_exception.
+     */
+    template<class T, class Allocator>
+    void read_chunks(std::istream &in, std::vector<T, Allocator> &values, std::uint64_t count, T const &fill = T())
+    {
+        for (std::uint64_t first = 0; first < count; first += chunk_size) {
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(count - first, chunk_size));
+            const std::size_t offset = values.size();
+
+            values.resize(offset + n, fill);
+            read_block(in, values.data() + offset, n);
+        }
+    }
+
+    /**
+     * @brief This function reads a block of positions by chunks (see read_chunks).
+     * @param [in] count This parameter refers to the number of positions, as read from the stream.
+     * @param [in] bound This parameter refers to the number of positions of the container: every position must be
+     * lower.
+     * @throw If the stream ends before the block or a position is out of bounds, the function throws an
+     * exceptions::snapshot_exception.
+     */
+    inline std::vector<std::uint64_t> read_positions(std::istream &in, std::uint64_t count, std::size_t bound)
+    {
+        std::vector<std::uint64_t> positions;
+
+        read_chunks(in, positions, count);
+        if (std::any_of(positions.begin(), positions.end(), [bound](std::uint64_t pos) { return pos >= bound; }))
+            throw exceptions::snapshot_exception("position out of bounds in the snapshot");
+        return (positions);
+    }
+
+    /**
+     * @brief This function writes the number of components, the block of their positions and the components stored
+     * at given positions of a container.
+     * @throw If the stream fails, the function throws an exceptions::snapshot_exception.
+     */
+    template<class Storage>
+    void write_components(std::ostream &out, Storage const &storage, std::vector<std::uint64_t> const &positions)
+    {
+        using component_type = typename Storage::component_type;
+
+        const std::uint64_t count = positions.size();
+
+        write_block(out, &count, 1);
+        write_block(out, positions.data(), positions.size());
+        if constexpr (has_codec_v<component_type>) {
+            for (auto const pos : positions)
+                codec<component_type>::write(out, storage.get(pos));
+            if (!out)
+                throw exceptions::snapshot_exception("failed to write the snapshot");
+        } else {
+            std::vector<component_type> chunk;
+
+            chunk.reserve(std::min<std::size_t>(count, chunk_size));
+            for (std::size_t first = 0; first < count; first += chunk_size) {
+                const std::size_t last = std::min<std::size_t>(count, first + chunk_size);
+
+                chunk.clear();
+                for (std::size_t i = first; i < last; ++i)
+                    chunk.push_back(storage.get(positions[i]));
+                write_block(out, chunk.data(), chunk.size());
+            }
+        }
+    }
+
+    /**
+     * @brief This function reads components written by write_components and stores them in a container, replacing
+     * the components already stored at their positions. Trivially copyable components are read by chunks and inserted
+     * with insert_range, without going through the registry.
+     * @param [in] bound This parameter refers to the number of positions of the container (see read_positions).
+     * @throw If the stream ends early or holds a position out of bounds, the function throws an
+     * exceptions::snapshot_exception.
+     */
+    template<class Storage>
+    void read_components(std::istream &in, Storage &storage, std::size_t bound)
+    {
+        using component_type = typename Storage::component_type;
+
+        std::uint64_t count = 0;
+
+        read_block(in, &count, 1);
+
+        const std::vector<std::uint64_t> positions = read_positions(in, count, bound);
+
+        if constexpr (!assertion::has_presence_v<Storage>)
+            storage.reserve(storage.size() + count);
+        if constexpr (has_codec_v<component_type>) {
+            for (auto const pos : positions) {
+                storage.insert_at(pos, codec<component_type>::read(in));
+                if (!in)
+                    throw exceptions::snapshot_exception("unexpected end of the snapshot");
+            }
+        } else {
+            std::vector<component_type> chunk(std::min<std::size_t>(count, chunk_size));
+
+            for (std::size_t first = 0; first < count; first += chunk_size) {
+                const std::size_t n = std::min<std::size_t>(count - first, chunk_size);
+
+                read_block(in, chunk.data(), n);
+                storage.insert_range(positions.begin() + first, positions.begin() + first + n, chunk.data());
+            }
+        }
+    }
+
+    /**
+     * @brief This function writes the components of a container.
+     * @tparam Storage This template refers to the type of the container (sparse_array, sparse_set or transient_set).
+     * @param [in] out This parameter refers to the stream to write to.
+     * @param [in] storage This parameter refers to the container.
+     * @throw If the component is not serializable or the stream fails, the function throws an
+     * exceptions::snapshot_exception.
+     */
+    template<class Storage>
+    void save(std::ostream &out, Storage const &storage)
+    {
+        using component_type = typename Storage::component_type;
+
+        if constexpr (!is_serializable_v<component_type>) {
+            throw exceptions::snapshot_exception(
+                std::string("component ") + typeid(component_type).name() + " has no codec"
+            );
+        } else {
+            std::vector<std::uint64_t> positions;
+
+            positions.reserve(storage.count());
+            if constexpr (assertion::has_presence_v<Storage>)
+                for (auto pos = storage.next(0); pos < storage.size(); pos = storage.next(pos + 1))
+                    positions.push_back(pos);
+            else
+                positions.assign(storage.entities().begin(), storage.entities().end());
+            write_components(out, storage, positions);
+        }
+    }
+
+    /**
+     * @brief This function replaces the components of a container with the components read from a stream.
+     * @tparam Storage This template refers to the type of the container (sparse_array, sparse_set or transient_set).
+     * @param [in] in This parameter refers to the stream to read from.
+     * @param [out] storage This parameter refers to the container.
+     * @param [in] bound This parameter refers to the number of positions the components can be stored at, the
+     * number of entity slots for a registry.
+     * @throw If the component is not serializable, the stream ends early or holds a position out of bounds, the
+     * function throws an exceptions::snapshot_exception.
+     */
+    template<class Storage>
+    void load(std::istream &in, Storage &storage, std::size_t bound)
+    {
+        using component_type = typename Storage::component_type;
+
+        if constexpr (!is_serializable_v<component_type>) {
+            throw exceptions::snapshot_exception(
+                std::string("component ") + typeid(component_type).name() + " has no codec"
+            );
+        } else {
+            storage.clear();
+            read_components(in, storage, bound);
+        }
+    }
+
+    /**
+     * @brief This function writes the changes of a sparse_array since a given tick: the block of the positions whose
+     * component was removed, then the components added or changed as written by write_components.
+     * @param [in] out This parameter refers to the stream to write to.
+     * @param [in] storage This parameter refers to the container.
+     * @param [in] since This parameter refers to the tick (see sparse_array::each_change).
+     * @throw If the component is not serializable or the stream fails, the function throws an
+     * exceptions::snapshot_exception.
+     */
+    template<class Storage>
+    void save_changes(std::ostream &out, Storage const &storage, typename Storage::tick_type since)
+    {
+        using component_type = typename Storage::component_type;
+
+        if constexpr (!is_serializable_v<component_type>) {
+            throw exceptions::snapshot_exception(
+                std::string("component ") + typeid(component_type).name() + " has no codec"
+            );
+        } else {
+            std::vector<std::uint64_t> positions;
+
+            storage.each_removal(since, [&positions](std::size_t pos) {
+                positions.push_back(pos);
+            });
+
+            const std::uint64_t removed = positions.size();
+
+            write_block(out, &removed, 1);
+            write_block(out, positions.data(), positions.size());
+            positions.clear();
+            storage.each_change(since, [&positions](std::size_t pos, bool) {
+                positions.push_back(pos);
+            });
+            write_components(out, storage, positions);
+        }
+    }
+
+    /**
+     * @brief This function applies changes written by save_changes to a sparse_array: removals first, then additions
+     * and changes.
+     * @param [in] in This parameter refers to the stream to read from.
+     * @param [out] storage This parameter refers to the container.
+     * @param [in] bound This parameter refers to the number of positions the components can be stored at (see
+     * load).
+     * @throw If the component is not serializable, the stream ends early or holds a position out of bounds, the
+     * function throws an exceptions::snapshot_exception.
+     */
+    template<class Storage>
+    void load_changes(std::istream &in, Storage &storage, std::size_t bound)
+    {
+        using component_type = typename Storage::component_type;
+
+        if constexpr (!is_serializable_v<component_type>) {
+            throw exceptions::snapshot_exception(
+                std::string("component ") + typeid(component_type).name() + " has no codec"
+            );
+        } else {
+            std::uint64_t removed = 0;
+
+            read_block(in, &removed, 1);
+            for (auto const pos : read_positions(in, removed, bound))
+                storage.erase(pos);
+            read_components(in, storage, bound);
+        }
+    }
+}
+
+#endif //SNAPSHOT_HPP
@@ -0,0 +1,741 @@
+#ifndef SOA_ARRAY_HPP
+#define SOA_ARRAY_HPP
+
+#include <array>
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "bitset.hpp"
+#include "page_table.hpp"
+#include "span.hpp"
+
+namespace ecs
+{
+    /**
+     * @brief The soa_fields struct lists the fields of an aggregate component, to store it in a
+     * containers::soa_array. Specialize it with a tuple of pointers to every field of the component:
+     * @code
+     * template<>
+     * struct ecs::soa_fields<velocity>
+     * {
+     *     static constexpr auto members = std::make_tuple(&velocity::x, &velocity::y);
+     * };
+     * @endcode
+     * Fields must be trivially copyable, and the component default constructible: the fields that are not listed are
+     * not stored.
+     * @tparam Component This template parameter refers to the component.
+     */
+    template<class Component>
+    struct soa_fields;
+}
+
+namespace ecs::containers
+{
+    template<class Member>
+    struct soa_member;
+
+    template<class Class, class Field>
+    struct soa_member<Field Class::*>
+    {
+        using field_type = Field;
+    };
+
+    template<class Component>
+    using soa_members_t = std::decay_t<decltype(soa_fields<std::remove_const_t<Component>>::members)>;
+
+    /**
+     * @brief Number of fields of a component stored in a soa_array.
+     */
+    template<class Component>
+    constexpr inline std::size_t soa_size_v = std::tuple_size_v<soa_members_t<Component>>;
+
+    /**
+     * @brief Type of the field I of a component stored in a soa_array, const if the component is const.
+     */
+    template<class Component, std::size_t I>
+    using soa_field_t = std::conditional_t<
+        std::is_const_v<Component>,
+        typename soa_member<std::tuple_element_t<I, soa_members_t<Component>>>::field_type const,
+        typename soa_member<std::tuple_element_t<I, soa_members_t<Component>>>::field_type
+    >;
+
+    template<class Component, auto Member, std::size_t ... Is>
+    [[nodiscard]] constexpr std::size_t soa_index(std::index_sequence<Is...>) noexcept
+    {
+        std::size_t index = sizeof...(Is);
+
+        ([&index](auto member) {
+            if constexpr (std::is_same_v<decltype(member), decltype(Member)>)
+                if (member == Member)
+                    index = Is;
+        }(std::get<Is>(soa_fields<std::remove_const_t<Component>>::members)), ...);
+        return (index);
+    }
+
+    /**
+     * @brief Index of a field of a component stored in a soa_array, from the pointer to the field.
+     */
+    template<class Component, auto Member>
+    constexpr inline std::size_t soa_index_v =
+        soa_index<Component, Member>(std::make_index_sequence<soa_size_v<Component>>());
+
+    /**
+     * @brief This class refers to a reference to a component stored in a soa_array, made of a pointer to each of its
+     * fields. Fields are accessed with get<I>() or field<&Component::member>(), and with structured bindings. Assigning
+     * a component or another reference writes every field, converting the reference reads every field.
+     * @tparam Component This template refers to the type of the component, const to read the fields only.
+     */
+    template<class Component>
+    class soa_reference
+    {
+        public:
+            using component_type = std::remove_const_t<Component>;
+
+            template<class ... Fields>
+            explicit soa_reference(Fields *...fields) noexcept :
+                _fields{ fields... }
+            {}
+
+            soa_reference(soa_reference const &other) noexcept = default;
+
+            soa_reference &operator=(soa_reference const &other)
+            {
+                std::as_const(*this) = component_type(other);
+                return (*this);
+            }
+
+            soa_reference const &operator=(soa_reference const &other) const
+            {
+                return (*this = component_type(other));
+            }
+
+            soa_reference const &operator=(component_type const &component) const
+            {
+                static_assert(!std::is_const_v<Component>, "A const reference can't be assigned.");
+
+                _assign(component, std::make_index_sequence<soa_size_v<Component>>());
+                return (*this);
+            }
+
+            /**
+             * @brief This method returns a copy of the component.
+             */
+            operator component_type() const
+            {
+                component_type component{};
+
+                _read(component, std::make_index_sequence<soa_size_v<Component>>());
+                return (component);
+            }
+
+            template<std::size_t I>
+            [[nodiscard]] soa_field_t<Component, I> &get() const noexcept
+            {
+                return (*static_cast<soa_field_t<Component, I> *>(_fields[I]));
+            }
+
+            template<auto Member>
+            [[nodiscard]] soa_field_t<Component, soa_index_v<Component, Member>> &field() const noexcept
+            {
+                return get<soa_index_v<Component, Member>>();
+            }
+
+        private:
+            using pointer = std::conditional_t<std::is_const_v<Component>, void const *, void *>;
+
+            std::array<pointer, soa_size_v<Component>> _fields;
+
+            template<std::size_t ... Is>
+            void _assign(component_type const &component, std::index_sequence<Is...>) const
+            {
+                ((get<Is>() = component.*std::get<Is>(soa_fields<component_type>::members)), ...);
+            }
+
+            template<std::size_t ... Is>
+            void _read(component_type &component, std::index_sequence<Is...>) const
+            {
+                ((component.*std::get<Is>(soa_fields<component_type>::members) = get<Is>()), ...);
+            }
+    };
+
+    /**
+     * @brief This class refers to a view over consecutive components of a soa_array, made of a span of each of their
+     * fields. Loops over the spans of the fields are loops over plain arrays, which the compiler vectorizes.
+     * @tparam Component This template refers to the type of the component, const to read the fields only.
+     */
+    template<class Component>
+    class soa_span
+    {
+        public:
+            using size_type = std::size_t;
+
+            template<class ... Fields>
+            explicit soa_span(size_type size, Fields *...fields) noexcept :
+                _fields{ fields... },
+                _size(size)
+            {}
+
+            [[nodiscard]] size_type size() const noexcept
+            {
+                return _size;
+            }
+
+            template<std::size_t I>
+            [[nodiscard]] span<soa_field_t<Component, I>> get() const noexcept
+            {
+                return span<soa_field_t<Component, I>>(static_cast<soa_field_t<Component, I> *>(_fields[I]), _size);
+            }
+
+            template<auto Member>
+            [[nodiscard]] span<soa_field_t<Component, soa_index_v<Component, Member>>> field() const noexcept
+            {
+                return get<soa_index_v<Component, Member>>();
+            }
+
+            /**
+             * @brief This method returns a reference to a component of the span.
+             */
+            [[nodiscard]] soa_reference<Component> operator[](size_type index) const noexcept
+            {
+                return _reference(index, std::make_index_sequence<soa_size_v<Component>>());
+            }
+
+        private:
+            using pointer = std::conditional_t<std::is_const_v<Component>, void const *, void *>;
+
+            std::array<pointer, soa_size_v<Component>> _fields;
+
+            size_type _size;
+
+            template<std::size_t ... Is>
+            [[nodiscard]] soa_reference<Component> _reference(size_type index,
+                std::index_sequence<Is...>) const noexcept
+            {
+                return soa_reference<Component>(&get<Is>()[index]...);
+            }
+    };
+
+    /**
+     * @brief This class refers to an array of aggregate Components indexed by entity, stored field by field
+     * (structure of arrays): every field listed by ecs::soa_fields lives in its own contiguous array, in pages of
+     * page_size positions allocated on demand and aligned on a cache line. Loops touching a few fields of many
+     * components read only these fields, and a loop over the columns of a page (see column) is a plain loop over
+     * arrays the compiler vectorizes:
+     * @code
+     * for (std::size_t page = 0; page < positions.pages(); ++page)
+     *     if (auto *x = positions.column<0>(page); x && velocities.column<0>(page))
+     *         for (std::size_t i = 0; i < positions.page_size; ++i)
+     *             x[i] += velocities.column<0>(page)[i] * dt;
+     * @endcode
+     * It is a drop-in replacement of sparse_array for the zippers, the registry and the snapshots, except that
+     * components are handed out as soa_reference proxies instead of references. A presence bitset tells which
+     * positions store a component.
+     * @tparam Component This template refers to the type of the component, ecs::soa_fields must be specialized for it.
+     * @tparam Allocator This template refers to the allocator used for the columns and the bitset.
+     */
+    template<class Component, class Allocator = std::allocator<Component>>
+    class soa_array
+    {
+        public:
+            using component_type = Component;
+
+            using allocator_type = Allocator;
+
+            using value_type = Component;
+
+            using reference_type = soa_reference<Component>;
+
+            using const_reference_type = soa_reference<Component const>;
+
+            using size_type = std::size_t;
+
+            template<std::size_t I>
+            using field_type = soa_field_t<Component, I>;
+
+            /**
+             * @brief Number of positions of a page, the length of a column.
+             */
+            static constexpr size_type page_size = 1024;
+
+            /**
+             * @brief Alignment of the columns, in bytes.
+             */
+            static constexpr size_type alignment = 64;
+
+            static_assert(page_size % bitset::word_bits == 0, "Pages must hold a whole number of presence words.");
+
+            static_assert(std::is_default_constructible_v<Component>, "Components must be default constructible.");
+
+            soa_array() :
+                soa_array(Allocator())
+            {}
+
+            explicit soa_array(Allocator const &allocator) :
+                _columns(_make_columns(allocator, fields())),
+                _presence(word_allocator(allocator)),
+                _size(0),
+                _count(0)
+            {}
+
+            soa_array(soa_array const &other, Allocator const &allocator) :
+                _columns(_copy_columns(other, allocator, fields())),
+                _presence(other._presence, word_allocator(allocator)),
+                _size(other._size),
+                _count(other._count)
+            {}
+
+            soa_array(soa_array const &other) :
+                soa_array(
+                    other,
+                    std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator())
+                )
+            {}
+
+            soa_array(soa_array &&other) noexcept :
+                _columns(std::move(other._columns)),
+                _presence(std::move(other._presence)),
+                _size(std::exchange(other._size, 0)),
+                _count(std::exchange(other._count, 0))
+            {}
+
+            ~soa_array() = default;
+
+            /**
+             * @brief The columns and the bitset already allocated are reused (see page_table::operator=).
+             */
+            soa_array &operator=(soa_array const &other)
+            {
+                if (this != &other) {
+                    _columns = other._columns;
+                    _presence = other._presence;
+                    _size = other._size;
+                    _count = other._count;
+                }
+                return (*this);
+            }
+
+            soa_array &operator=(soa_array &&other) noexcept(std::is_nothrow_move_assignable_v<columns>)
+            {
+                if (this != &other) {
+                    _columns = std::move(other._columns);
+                    _presence = std::move(other._presence);
+                    other._presence.clear();
+                    _size = std::exchange(other._size, 0);
+                    _count = std::exchange(other._count, 0);
+                }
+                return (*this);
+            }
+
+            /**
+             * @brief This method returns the allocator of the soa_array.
+             */
+            [[nodiscard]] allocator_type get_allocator() const noexcept
+            {
+                return allocator_type(std::get<0>(_columns).get_allocator());
+            }
+
+            /**
+             * @brief This method returns a reference to the component stored at a given position, allocating its
+             * page if needed.
+             * @param [in] index This parameter refers to the position of the component.
+             */
+            [[nodiscard]] reference_type operator[](size_type index)
+            {
+                _cover(index);
+                _allocate(index / page_size, fields());
+                return get(index);
+            }
+
+            /**
+             * @brief This method returns a reference to the component stored at a given position without checking
+             * it exists. It is the accessor used by the zippers.
+             * @param [in] pos This parameter refers to the position of the component.
+             */
+            [[nodiscard]] reference_type get(size_type pos) noexcept
+            {
+                return _reference<reference_type>(*this, pos, fields());
+            }
+
+            [[nodiscard]] const_reference_type get(size_type pos) const noexcept
+            {
+                return _reference<const_reference_type>(*this, pos, fields());
+            }
+
+            /**
+             * @brief This method checks whether a component is stored at a given position.
+             * @param [in] pos This parameter refers to the position of the component.
+             */
+            [[nodiscard]] bool contains(size_type pos) const noexcept
+            {
+                return pos < _size && (_presence[pos / bitset::word_bits] >> (pos % bitset::word_bits)) & 1;
+            }
+
+            /**
+             * @brief This method returns the position of the first component stored at or after a given position.
+             * @param [in] pos This parameter refers to the position to start searching from.
+             * @return The position of the component, or size() if there is none.
+             */
+            [[nodiscard]] size_type next(size_type pos) const noexcept
+            {
+                return bitset::find_first<1>({ _presence.data() }, pos, _size);
+            }
+
+            /**
+             * @brief This method returns the presence bitset of the soa_array (see sparse_array::presence).
+             */
+            [[nodiscard]] auto const &presence() const noexcept
+            {
+                return _presence;
+            }
+
+            /**
+             * @brief This method returns the components stored at count consecutive positions (see each_batch).
+             * @param [in] pos This parameter refers to the first position.
+             * @param [in] count This parameter refers to the number of positions, which must all store a component
+             * and lie in the page of pos.
+             */
+            [[nodiscard]] soa_span<Component> components(size_type pos, size_type count) noexcept
+            {
+                return _span<soa_span<Component>>(*this, pos, count, fields());
+            }
+
+            [[nodiscard]] soa_span<Component const> components(size_type pos, size_type count) const noexcept
+            {
+                return _span<soa_span<Component const>>(*this, pos, count, fields());
+            }
+
+            /**
+             * @brief This method returns the number of pages covered by the soa_array, allocated or not.
+             */
+            [[nodiscard]] size_type pages() const noexcept
+            {
+                return std::get<0>(_columns).size();
+            }
+
+            /**
+             * @brief This method returns the values of a field for the page_size positions of a page, aligned on
+             * alignment bytes. The values of the positions without a component are unspecified and may be modified.
+             * @tparam I This template refers to the index of the field in ecs::soa_fields.
+             * @param [in] page This parameter refers to the page, lower than pages().
+             * @return The column, or nullptr if no component was ever stored in the page.
+             */
+            template<std::size_t I>
+            [[nodiscard]] field_type<I> *column(size_type page) noexcept
+            {
+                auto *columns = std::get<I>(_columns)[page];
+
+                return columns ? (*columns)[0].values : nullptr;
+            }
+
+            template<std::size_t I>
+            [[nodiscard]] field_type<I> const *column(size_type page) const noexcept
+            {
+                auto const *columns = std::get<I>(_columns)[page];
+
+                return columns ? (*columns)[0].values : nullptr;
+            }
+
+            /**
+             * @brief This method returns the size of the soa_array: one past the last position storing a component.
+             */
+            [[nodiscard]] size_type size() const noexcept
+            {
+                return _size;
+            }
+
+            /**
+             * @brief This method returns the number of components stored in the soa_array.
+             */
+            [[nodiscard]] size_type count() const noexcept
+            {
+                return _count;
+            }
+
+            /**
+             * @brief This method reserves the columns and the presence bitset for the positions lower than a given
+             * value. Pages are still allocated when a component is first stored in them.
+             * @param [in] capacity This parameter refers to the number of positions to reserve.
+             */
+            void reserve(size_type capacity)
+            {
+                if (capacity > 0)
+                    _cover(capacity - 1);
+            }
+
+            /**
+             * @brief This method removes all components from the soa_array. Pages are kept.
+             */
+            void clear() noexcept
+            {
+                std::fill(_presence.begin(), _presence.end(), bitset::word_type{0});
+                _size = 0;
+                _count = 0;
+            }
+
+            /**
+             * @brief This method stores a component at a given position, replacing the component stored there.
+             * @param [in] pos This parameter refers to the position of the component.
+             * @param [in] component This parameter refers to the component.
+             * @return A reference to the component stored.
+             */
+            reference_type insert_at(size_type pos, Component const &component)
+            {
+                auto ref = _slot(pos);
+
+                ref = component;
+                _mark(pos);
+                _grow(pos);
+                return (ref);
+            }
+
+            /**
+             * @brief This method constructs a component and stores it at a given position.
+             * @tparam Params This variadic template refers to the type of the parameters of the component, built as
+             * Component{parameters...}.
+             * @param [in] pos This parameter refers to the position of the component.
+             * @param [in] parameters This parameter refers to the parameters to build the component from.
+             * @return A reference to the component stored.
+             */
+            template<class ... Params>
+            reference_type emplace_at(size_type pos, Params &&...parameters)
+            {
+                return insert_at(pos, Component{std::forward<Params>(parameters)...});
+            }
+
+            /**
+             * @brief This method stores components at several positions. Storage is grown once for all the positions.
+             * @tparam PositionIt This template refers to the type of the forward iterator over the positions.
+             * @tparam ValueIt This template refers to the type of the iterator over the components.
+             * @param [in] first This parameter refers to the beginning of the positions.
+             * @param [in] last This parameter refers to the end of the positions.
+             * @param [in] values This parameter refers to the beginning of the components, one per position.
+             */
+            template<class PositionIt, class ValueIt>
+            void insert_range(PositionIt first, PositionIt last, ValueIt values)
+            {
+                if (first == last)
+                    return;
+
+                const size_type back = _back(first, last);
+
+                _cover(back);
+                for (; first != last; ++first, ++values) {
+                    const auto pos = static_cast<size_type>(*first);
+
+                    _slot(pos) = static_cast<Component const &>(*values);
+                    _mark(pos);
+                }
+                _grow(back);
+            }
+
+            /**
+             * @brief This method stores the same component at several positions. Storage is grown once for all the
+             * positions.
+             * @tparam PositionIt This template refers to the type of the forward iterator over the positions.
+             * @tparam Params This variadic template refers to the type of the parameters of the component.
+             * @param [in] first This parameter refers to the beginning of the positions.
+             * @param [in] last This parameter refers to the end of the positions.
+             * @param [in] parameters This parameter refers to the parameters to build the component from.
+             */
+            template<class PositionIt, class ... Params>
+            void emplace_n(PositionIt first, PositionIt last, Params const &...parameters)
+            {
+                if (first == last)
+                    return;
+
+                const Component component{parameters...};
+                const size_type back = _back(first, last);
+
+                _cover(back);
+                for (; first != last; ++first) {
+                    const auto pos = static_cast<size_type>(*first);
+
+                    _slot(pos) = component;
+                    _mark(pos);
+                }
+                _grow(back);
+            }
+
+            /**
+             * @brief This method erases the component stored at a given position. Does nothing if no component is
+             * stored there.
+             * @param [in] pos This parameter refers to the position of the component.
+             */
+            void erase(size_type pos) noexcept
+            {
+                if (contains(pos)) {
+                    _presence[pos / bitset::word_bits] &= ~(bitset::word_type{1} << (pos % bitset::word_bits));
+                    _count--;
+                }
+            }
+
+            /**
+             * @brief This method erases the components stored at several positions, positions without one are
+             * ignored. The number of components is updated once for all the positions.
+             * @tparam PositionIt This template refers to the type of the iterator over the positions.
+             * @param [in] first This parameter refers to the beginning of the positions.
+             * @param [in] last This parameter refers to the end of the positions.
+             */
+            template<class PositionIt>
+            void erase_range(PositionIt first, PositionIt last) noexcept
+            {
+                size_type erased = 0;
+
+                for (; first != last; ++first) {
+                    const auto pos = static_cast<size_type>(*first);
+
+                    if (pos >= _size)
+                        continue;
+
+                    auto &word = _presence[pos / bitset::word_bits];
+                    const bitset::word_type bit = bitset::word_type{1} << (pos % bitset::word_bits);
+
+                    erased += (word & bit) != 0;
+                    word &= ~bit;
+                }
+                _count -= erased;
+            }
+
+        private:
+            template<class Field>
+            struct alignas(alignment) block
+            {
+                Field values[page_size];
+            };
+
+            template<std::size_t I>
+            using column_table = page_table<block<std::remove_const_t<field_type<I>>>, 1, Allocator>;
+
+            template<std::size_t ... Is>
+            static auto _columns_type(std::index_sequence<Is...>) -> std::tuple<column_table<Is>...>;
+
+            using fields = std::make_index_sequence<soa_size_v<Component>>;
+
+            using columns = decltype(_columns_type(fields()));
+
+            using word_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<bitset::word_type>;
+
+            columns _columns;
+
+            std::vector<bitset::word_type, word_allocator> _presence;
+
+            size_type _size;
+
+            size_type _count;
+
+            template<std::size_t ... Is>
+            [[nodiscard]] static columns _make_columns(Allocator const &allocator, std::index_sequence<Is...>)
+            {
+                static_assert(
+                    (std::is_trivially_copyable_v<std::remove_const_t<field_type<Is>>> && ...),
+                    "The fields of a component stored in a soa_array must be trivially copyable."
+                );
+
+                return columns(column_table<Is>(allocator)...);
+            }
+
+            template<std::size_t ... Is>
+            [[nodiscard]] static columns _copy_columns(soa_array const &other, Allocator const &allocator,
+                std::index_sequence<Is...>)
+            {
+                return columns(column_table<Is>(std::get<Is>(other._columns), allocator)...);
+            }
+
+            template<class Reference, class Self, std::size_t ... Is>
+            [[nodiscard]] static Reference _reference(Self &self, size_type pos, std::index_sequence<Is...>) noexcept
+            {
+                const size_type page = pos / page_size;
+                const size_type index = pos % page_size;
+
+                return Reference(&(*std::get<Is>(self._columns)[page])[0].values[index]...);
+            }
+
+            template<class Span, class Self, std::size_t ... Is>
+            [[nodiscard]] static Span _span(Self &self, size_type pos, size_type count,
+                std::index_sequence<Is...>) noexcept
+            {
+                const size_type page = pos / page_size;
+                const size_type index = pos % page_size;
+
+                return Span(count, &(*std::get<Is>(self._columns)[page])[0].values[index]...);
+            }
+
+            template<std::size_t ... Is>
+            void _allocate(size_type page, std::index_sequence<Is...>)
+            {
+                (std::get<Is>(_columns).allocate(page), ...);
+            }
+
+            template<std::size_t ... Is>
+            void _resize(size_type pages, std::index_sequence<Is...>)
+            {
+                (std::get<Is>(_columns).resize(pages), ...);
+            }
+
+            /**
+             * @brief Grows the columns and the presence bitset to cover a given position.
+             */
+            void _cover(size_type pos)
+            {
+                const size_type page = pos / page_size;
+
+                if (page >= pages()) {
+                    _presence.resize((page + 1) * (page_size / bitset::word_bits));
+                    _resize(page + 1, fields());
+                }
+            }
+
+            template<class PositionIt>
+            [[nodiscard]] static size_type _back(PositionIt first, PositionIt last)
+            {
+                size_type back = 0;
+
+                for (; first != last; ++first)
+                    back = std::max(back, static_cast<size_type>(*first));
+                return (back);
+            }
+
+            /**
+             * @brief Returns the reference of a position about to store a component, counting it if it is new.
+             */
+            [[nodiscard]] reference_type _slot(size_type pos)
+            {
+                _cover(pos);
+                _allocate(pos / page_size, fields());
+                if (!contains(pos))
+                    _count++;
+                return get(pos);
+            }
+
+            void _mark(size_type pos) noexcept
+            {
+                _presence[pos / bitset::word_bits] |= bitset::word_type{1} << (pos % bitset::word_bits);
+            }
+
+            void _grow(size_type pos) noexcept
+            {
+                if (pos >= _size)
+                    _size = pos + 1;
+            }
+    };
+}
+
+namespace std
+{
+    template<class Component>
+    struct tuple_size<ecs::containers::soa_reference<Component>> :
+        std::integral_constant<std::size_t, ecs::containers::soa_size_v<Component>> {};
+
+    template<std::size_t I, class Component>
+    struct tuple_element<I, ecs::containers::soa_reference<Component>>
+    {
+        using type = ecs::containers::soa_field_t<Component, I> &;
+    };
+}
+
+#endif //SOA_ARRAY_HPP
@@ -0,0 +1,116 @@
+#ifndef SPAN_HPP
+#define SPAN_HPP
+
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+namespace ecs::containers
+{
+    /**
+     * @brief This class refers to a view over count contiguous values, the std::span of C++20.
+     * @tparam T This template refers to the type of the values, const to read them only.
+     */
+    template<class T>
+    class span
+    {
+        public:
+            using value_type = std::remove_const_t<T>;
+
+            using size_type = std::size_t;
+
+            span() noexcept :
+                _data(nullptr),
+                _size(0)
+            {}
+
+            span(T *data, size_type size) noexcept :
+                _data(data),
+                _size(size)
+            {}
+
+            [[nodiscard]] T *data() const noexcept
+            {
+                return _data;
+            }
+
+            [[nodiscard]] size_type size() const noexcept
+            {
+                return _size;
+            }
+
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return _size == 0;
+            }
+
+            [[nodiscard]] T &operator[](size_type index) const noexcept
+            {
+                return _data[index];
+            }
+
+            [[nodiscard]] T *begin() const noexcept
+            {
+                return _data;
+            }
+
+            [[nodiscard]] T *end() const noexcept
+            {
+                return _data + _size;
+            }
+
+        private:
+            T *_data;
+
+            size_type _size;
+    };
+
+    /**
+     * @brief This class refers to a view over count consecutive slots of a sparse_array that all store a component:
+     * operator[] returns the component itself. The components are not contiguous, they are strided by the size of
+     * std::optional<Component>, so loops over the view are not vectorized like loops over a soa_span.
+     * @tparam Component This template refers to the type of the component, const to read the components only.
+     */
+    template<class Component>
+    class component_span
+    {
+        public:
+            using slot_type = std::conditional_t<
+                std::is_const_v<Component>,
+                std::optional<std::remove_const_t<Component>> const,
+                std::optional<Component>
+            >;
+
+            using size_type = std::size_t;
+
+            component_span(slot_type *slots, size_type size) noexcept :
+                _slots(slots),
+                _size(size)
+            {}
+
+            [[nodiscard]] size_type size() const noexcept
+            {
+                return _size;
+            }
+
+            [[nodiscard]] Component &operator[](size_type index) const noexcept
+            {
+                return (*_slots[index]);
+            }
+
+            /**
+             * @brief This method returns the slots of the span.
+             */
+            [[nodiscard]] span<slot_type> slots() const noexcept
+            {
+                return span<slot_type>(_slots, _size);
+            }
+
+        private:
+            slot_type *_slots;
+
+            size_type _size;
+    };
+}
+
+#endif //SPAN_HPP
@@ -1,105 +1,287 @@
 #ifndef SPARSE_ARRAY_HPP
 #define SPARSE_ARRAY_HPP
 
+#include <array>
+#include <memory>
 #include <vector>
+#include <cstdint>
+#include <utility>
 #include <optional>
+#include <type_traits>
 #include <algorithm>
 #include <stdexcept>
+#include <functional>
+
+#include "bitset.hpp"
+#include "change_tracker.hpp"
+#include "page_table.hpp"
+#include "span.hpp"
+#include "sparse_array_iterator.hpp"
 
 namespace ecs::containers
 {
     /**
-     * @brief This class refers to an array of Components.
+     * @brief This class refers to an array of Components indexed by entity. Elements are stored in fixed-size pages
+     * allocated on demand: growing the array never moves the elements already stored, so references to them stay
+     * valid until they are erased or the array is destroyed. A presence bitset holding one bit per position tells which
+     * positions store a component without touching the pages. Once enabled with track_changes, additions, changes and
+     * removals are stamped with a tick so the changes made since a given tick can be listed (see each_change).
+     * @note Components must be added and removed with insert_at, emplace_at and erase, which keep track of the number
+     * of components stored and of the presence bitset. operator[] and the iterators hand out the stored
+     * std::optional itself: they are meant to read and modify components already stored. Assigning or resetting
+     * that optional directly leaves count(), contains() and the zippers unaware of the change.
      * @tparam Component This template refers to the type of the component.
+     * @tparam Allocator This template refers to the allocator used for the pages and the bitset, for instance a
+     * std::pmr::polymorphic_allocator to allocate them from a memory resource (see ecs::pmr).
      */
-    template<typename Component>
+    template<typename Component, class Allocator = std::allocator<Component>>
     class sparse_array
     {
         public:
+            using component_type = Component;
+
+            using allocator_type = Allocator;
+
             using value_type = std::optional<Component>;
 
             using reference_type = value_type &;
 
             using const_reference_type = value_type const &;
 
-            using container_type = std::vector<value_type>;
+            using size_type = std::size_t;
+
+            using tick_type = std::uint64_t;
+
+            using iterator = iterators::sparse_array_iterator<sparse_array>;
+
+            using const_iterator = iterators::sparse_array_iterator<sparse_array const>;
 
-            using size_type = typename container_type::size_type;
+            /**
+             * @brief Number of elements stored in a single page.
+             */
+            static constexpr size_type page_size =
+                sizeof(value_type) <= 16 ? 1024 :
+                sizeof(value_type) <= 64 ? 256 : 64;
 
-            using iterator = typename container_type::iterator;
+            static_assert(page_size % bitset::word_bits == 0, "Pages must hold a whole number of presence words.");
 
-            using const_iterator = typename container_type::const_iterator;
+            sparse_array() :
+                sparse_array(Allocator())
+            {}
 
-            sparse_array():
-                _data{}
+            explicit sparse_array(Allocator const &allocator) :
+                _pages(allocator),
+                _presence(word_allocator(allocator)),
+                _changes(allocator),
+                _size(0),
+                _count(0)
             {}
 
-            sparse_array(sparse_array const &other) = default;
+            sparse_array(sparse_array const &other, Allocator const &allocator) :
+                _pages(other._pages, allocator),
+                _presence(other._presence, word_allocator(allocator)),
+                _changes(other._changes, allocator),
+                _size(other._size),
+                _count(other._count)
+            {}
 
-            sparse_array(sparse_array &&other) noexcept = default;
+            sparse_array(sparse_array const &other) :
+                sparse_array(
+                    other,
+                    std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator())
+                )
+            {}
+
+            sparse_array(sparse_array &&other) noexcept :
+                _pages(std::move(other._pages)),
+                _presence(std::move(other._presence)),
+                _changes(std::move(other._changes)),
+                _size(std::exchange(other._size, 0)),
+                _count(std::exchange(other._count, 0))
+            {}
 
             ~sparse_array() = default;
 
-            sparse_array &operator=(sparse_array const &other) = default;
+            /**
+             * @brief The pages and the bitset already allocated are reused (see page_table::operator=): copying a
+             * sparse_array into one of the same shape, to restore a saved state, allocates nothing.
+             */
+            sparse_array &operator=(sparse_array const &other)
+            {
+                if (this != &other) {
+                    _pages = other._pages;
+                    _presence = other._presence;
+                    _changes = other._changes;
+                    _size = other._size;
+                    _count = other._count;
+                }
+                return (*this);
+            }
 
-            sparse_array &operator=(sparse_array &&other) noexcept = default;
+            sparse_array &operator=(sparse_array &&other) noexcept(std::is_nothrow_move_assignable_v<pages>)
+            {
+                if (this != &other) {
+                    _pages = std::move(other._pages);
+                    _presence = std::move(other._presence);
+                    other._presence.clear();
+                    _changes = std::move(other._changes);
+                    _size = std::exchange(other._size, 0);
+                    _count = std::exchange(other._count, 0);
+                }
+                return (*this);
+            }
 
+            /**
+             * @brief This method returns the allocator of the sparse_array.
+             */
+            [[nodiscard]] allocator_type get_allocator() const noexcept
+            {
+                return allocator_type(_pages.get_allocator());
+            }
+
+            /**
+             * @brief This method returns the element stored at a given position, allocating its page if needed.
+             * @param [in] index This parameter refers to the position of the element, it must be lower than size().
+             * @warning Use insert_at, emplace_at or erase to add or remove the component (see the note of the class).
+             */
             [[nodiscard]] reference_type operator[](size_t index)
             {
-                return _data[index];
+                auto &slot = _slot(index);
+
+                _changes.changed(index);
+                return (slot);
             }
 
+            /**
+             * @brief This method returns the element stored at a given position.
+             * @param [in] index This parameter refers to the position of the element, it must be lower than size().
+             */
             [[nodiscard]] const_reference_type operator[](size_t index) const
             {
-                return _data[index];
+                static const value_type empty{};
+                const size_type page = index / page_size;
+
+                if (page >= _pages.size() || !_pages[page])
+                    return empty;
+                return (*_pages[page])[index % page_size];
+            }
+
+            /**
+             * @brief This method returns the component stored at a given position without checking it exists.
+             * It is the accessor used by the zippers.
+             * @param [in] pos This parameter refers to the position of the component.
+             */
+            [[nodiscard]] Component &get(size_type pos)
+            {
+                _changes.changed(pos);
+                return *(*_pages[pos / page_size])[pos % page_size];
+            }
+
+            [[nodiscard]] Component const &get(size_type pos) const
+            {
+                return *(*_pages[pos / page_size])[pos % page_size];
+            }
+
+            /**
+             * @brief This method checks whether a component is stored at a given position.
+             * @param [in] pos This parameter refers to the position of the component.
+             */
+            [[nodiscard]] bool contains(size_type pos) const noexcept
+            {
+                return pos < _size && (_presence[pos / bitset::word_bits] >> (pos % bitset::word_bits)) & 1;
+            }
+
+            /**
+             * @brief This method returns the position of the first component stored at or after a given position.
+             * The presence bitset is scanned, the pages are not walked.
+             * @param [in] pos This parameter refers to the position to start searching from.
+             * @return The position of the component, or size() if there is none.
+             */
+            [[nodiscard]] size_type next(size_type pos) const noexcept
+            {
+                return bitset::find_first<1>({ _presence.data() }, pos, _size);
+            }
+
+            /**
+             * @brief This method returns the presence bitset of the sparse_array: bit i of word i / 64 is set when a
+             * component is stored at position i. The bitset covers every position lower than size().
+             */
+            [[nodiscard]] auto const &presence() const noexcept
+            {
+                return _presence;
             }
 
             /**
-             * @brief This method returns an iterator to the beginning of the internal vector.
+             * @brief This method returns the components stored at count consecutive positions (see each_batch), as a
+             * view over their slots rather than a contiguous array. The components are considered changed.
+             * @param [in] pos This parameter refers to the first position.
+             * @param [in] count This parameter refers to the number of positions, which must all store a component
+             * and lie in the page of pos.
+             */
+            [[nodiscard]] component_span<Component> components(size_type pos, size_type count)
+            {
+                if (_changes.enabled())
+                    for (size_type i = pos; i < pos + count; ++i)
+                        _changes.changed(i);
+                return component_span<Component>(&(*_pages[pos / page_size])[pos % page_size], count);
+            }
+
+            [[nodiscard]] component_span<Component const> components(size_type pos, size_type count) const noexcept
+            {
+                return component_span<Component const>(&(*_pages[pos / page_size])[pos % page_size], count);
+            }
+
+            /**
+             * @brief This method returns an iterator to the first element of the sparse_array.
+             * @note Dereferencing an iterator allocates the page of the element if needed, use a const_iterator to
+             * walk the array without allocating. Every component is considered changed, the writes through the
+             * iterators are not tracked one by one.
              */
             [[nodiscard]] iterator begin()
             {
-                return _data.begin();
+                _changes.changed_all();
+                return iterator(this, 0);
             }
 
             /**
-             * @brief This method returns a const iterator to the beginning of the internal vector.
+             * @brief This method returns a const iterator to the first element of the sparse_array.
              */
             [[nodiscard]] const_iterator begin() const
             {
-                return _data.begin();
+                return const_iterator(this, 0);
             }
 
             /**
-             * @brief This method returns a const iterator to the beginning of the internal vector.
+             * @brief This method returns a const iterator to the first element of the sparse_array.
              */
             [[nodiscard]] const_iterator cbegin() const
             {
-                return _data.cbegin();
+                return const_iterator(this, 0);
             }
 
             /**
-             * @brief This method returns an iterator to the end of the internal vector.
+             * @brief This method returns an iterator past the last element of the sparse_array.
              */
             [[nodiscard]] iterator end()
             {
-                return _data.end();
+                _changes.changed_all();
+                return iterator(this, _size);
             }
 
             /**
-             * @brief This method returns a const iterator to the end of the internal vector.
+             * @brief This method returns a const iterator past the last element of the sparse_array.
              */
             [[nodiscard]] const_iterator end() const
             {
-                return _data.end();
+                return const_iterator(this, _size);
             }
 
             /**
-             * @brief This method returns a const iterator to the end of the internal vector.
+             * @brief This method returns a const iterator past the last element of the sparse_array.
              */
             [[nodiscard]] const_iterator cend() const
             {
-                return _data.cend();
+                return const_iterator(this, _size);
             }
 
             /**
@@ -108,7 +290,40 @@ namespace ecs::containers
              */
             [[nodiscard]] size_type size() const
             {
-                return _data.size();
+                return _size;
+            }
+
+            /**
+             * @brief This method returns the number of components stored in the sparse_array.
+             */
+            [[nodiscard]] size_type count() const noexcept
+            {
+                return _count;
+            }
+
+            /**
+             * @brief This method reserves the page table and the presence bitset for the positions lower than a given
+             * value. Pages are still allocated when a component is first stored in them.
+             * @param [in] capacity This parameter refers to the number of positions to reserve.
+             */
+            void reserve(size_type capacity)
+            {
+                if (capacity > 0)
+                    _cover(capacity - 1);
+            }
+
+            /**
+             * @brief This method removes all components from the sparse_array. Pages are kept.
+             */
+            void clear()
+            {
+                for (size_type pos = next(0); pos < _size; pos = next(pos + 1)) {
+                    _changes.removed(pos);
+                    (*_pages[pos / page_size])[pos % page_size].reset();
+                }
+                std::fill(_presence.begin(), _presence.end(), bitset::word_type{0});
+                _size = 0;
+                _count = 0;
             }
 
             /**
@@ -120,10 +335,13 @@ namespace ecs::containers
              */
             reference_type insert_at(size_type pos, Component const &component)
             {
-                if (pos >= _data.size())
-                    _data.resize(pos + 1);
-                _data[pos] = component;
-                return (_data[pos]);
+                auto &slot = _slot(pos);
+
+                _track(pos, slot);
+                slot = component;
+                _mark(pos);
+                _grow(pos);
+                return (slot);
             }
 
             /**
@@ -135,10 +353,13 @@ namespace ecs::containers
              */
             reference_type insert_at(size_type pos, Component &&component)
             {
-                if (pos >= _data.size())
-                    _data.resize(pos + 1);
-                _data[pos] = std::forward<Component>(component);
-                return (_data[pos]);
+                auto &slot = _slot(pos);
+
+                _track(pos, slot);
+                slot = std::forward<Component>(component);
+                _mark(pos);
+                _grow(pos);
+                return (slot);
             }
 
             /**
@@ -151,23 +372,208 @@ namespace ecs::containers
             template<class ... Params>
             reference_type emplace_at(size_type pos, Params &&...parameters)
             {
-                auto allocator = _data.get_allocator();
-                using traits = std::allocator_traits<decltype(allocator)>;
+                auto &slot = _slot(pos);
+
+                _track(pos, slot);
+                slot.emplace(std::forward<Params>(parameters)...);
+                _mark(pos);
+                _grow(pos);
+                return (slot);
+            }
+
+            /**
+             * @brief This method assigns values to the components at several positions. Storage is grown once for all
+             * the positions.
+             * @tparam PositionIt This template refers to the type of the forward iterator over the positions.
+             * @tparam ValueIt This template refers to the type of the iterator over the values, use a move_iterator
+             * to move the values.
+             * @param [in] first This parameter refers to the beginning of the positions.
+             * @param [in] last This parameter refers to the end of the positions.
+             * @param [in] values This parameter refers to the beginning of the values, one per position.
+             */
+            template<class PositionIt, class ValueIt>
+            void insert_range(PositionIt first, PositionIt last, ValueIt values)
+            {
+                if (first == last)
+                    return;
+
+                const size_type back = _back(first, last);
 
-                if (pos >= _data.size())
-                    _data.resize(pos + 1);
-                traits::destroy(allocator, &_data[pos]);
-                traits::construct(allocator, &_data[pos], std::in_place, std::forward<Params>(parameters)...);
-                return (_data[pos]);
+                _cover(back);
+                for (; first != last; ++first, ++values) {
+                    const auto pos = static_cast<size_type>(*first);
+                    auto &slot = _slot(pos);
+
+                    _track(pos, slot);
+                    slot = *values;
+                    _mark(pos);
+                }
+                _grow(back);
             }
 
             /**
-             * @brief This method erases an element from the sparse_array.
+             * @brief This method constructs a component at several positions from the same parameters. Storage is
+             * grown once for all the positions.
+             * @tparam PositionIt This template refers to the type of the forward iterator over the positions.
+             * @tparam Params This variadic template refers to the type of the parameter to pass to the constructor.
+             * @param [in] first This parameter refers to the beginning of the positions.
+             * @param [in] last This parameter refers to the end of the positions.
+             * @param [in] parameters This parameter refers to the parameters to pass to every constructor.
+             */
+            template<class PositionIt, class ... Params>
+            void emplace_n(PositionIt first, PositionIt last, Params const &...parameters)
+            {
+                if (first == last)
+                    return;
+
+                const size_type back = _back(first, last);
+
+                _cover(back);
+                for (; first != last; ++first) {
+                    const auto pos = static_cast<size_type>(*first);
+                    auto &slot = _slot(pos);
+
+                    _track(pos, slot);
+                    slot.emplace(parameters...);
+                    _mark(pos);
+                }
+                _grow(back);
+            }
+
+            /**
+             * @brief This method erases an element from the sparse_array. Does nothing if no element is stored at
+             * the given position.
              * @param [in] pos The position of the element to erase.
              */
             void erase(size_type pos)
             {
-                _data.erase(pos);
+                const size_type page = pos / page_size;
+
+                if (pos < _size && _pages[page] && (*_pages[page])[pos % page_size].has_value()) {
+                    _changes.removed(pos);
+                    (*_pages[page])[pos % page_size].reset();
+                    _presence[pos / bitset::word_bits] &= ~(bitset::word_type{1} << (pos % bitset::word_bits));
+                    _count--;
+                }
+            }
+
+            /**
+             * @brief This method erases the components stored at several positions, positions without one are ignored.
+             * Consecutive positions sharing a presence word are erased together: the bits of the word are cleared at
+             * once and the number of components is updated once for all the positions.
+             * @tparam PositionIt This template refers to the type of the iterator over the positions.
+             * @param [in] first This parameter refers to the beginning of the positions.
+             * @param [in] last This parameter refers to the end of the positions.
+             */
+            template<class PositionIt>
+            void erase_range(PositionIt first, PositionIt last)
+            {
+                size_type erased = 0;
+                size_type word = 0;
+                bitset::word_type mask = 0;
+
+                for (; first != last; ++first) {
+                    const auto pos = static_cast<size_type>(*first);
+
+                    if (pos >= _size)
+                        continue;
+                    if (pos / bitset::word_bits != word) {
+                        erased += _erase_word(word, mask);
+                        word = pos / bitset::word_bits;
+                        mask = 0;
+                    }
+                    mask |= bitset::word_type{1} << (pos % bitset::word_bits);
+                }
+                erased += _erase_word(word, mask);
+                _count -= erased;
+            }
+
+            /**
+             * @brief This method returns the tick stamped on the components added, changed or removed.
+             */
+            [[nodiscard]] tick_type tick() const noexcept
+            {
+                return _changes.tick();
+            }
+
+            /**
+             * @brief This method sets the tick stamped on the components added, changed or removed from now on. The
+             * registry sets it to its own tick (see registry::tick).
+             * @param [in] tick This parameter refers to the tick, it must not be lower than the current one.
+             */
+            void set_tick(tick_type tick) noexcept
+            {
+                _changes.set_tick(tick);
+            }
+
+            /**
+             * @brief This method enables or disables the tracking of the changes. It is disabled by default: tracking
+             * stamps every write and logs every removal until discard_removals is called. Changes made while it is
+             * disabled are not listed, disabling it forgets the logged removals.
+             * @param [in] enabled This parameter refers to whether changes are tracked.
+             */
+            void track_changes(bool enabled = true)
+            {
+                _changes.enable(enabled);
+                for (size_type page = 0; page < _pages.size(); ++page)
+                    if (_pages[page])
+                        _changes.allocate(page);
+            }
+
+            /**
+             * @brief This method checks whether the changes are tracked (see track_changes).
+             */
+            [[nodiscard]] bool tracks_changes() const noexcept
+            {
+                return _changes.enabled();
+            }
+
+            /**
+             * @brief This method calls a function for every component added or changed since a given tick: inserted,
+             * emplaced or accessed through a non const accessor (operator[], get, begin). Pages without changes are
+             * skipped.
+             * @tparam Function This template refers to the type of the function, called as f(pos, added) where added
+             * is true when the component was added since the tick.
+             * @param [in] since This parameter refers to the tick, changes stamped with it are included.
+             * @param [in] f This parameter refers to the function to call.
+             */
+            template<class Function>
+            void each_change(tick_type since, Function &&f) const
+            {
+                for (size_type page = 0; page < _pages.size(); ++page) {
+                    if (!_pages[page] || !_changes.page_changed_since(page, since))
+                        continue;
+
+                    const size_type last = std::min(_size, (page + 1) * page_size);
+
+                    for (size_type pos = next(page * page_size); pos < last; pos = next(pos + 1))
+                        if (_changes.changed_since(pos, since))
+                            f(pos, _changes.added_since(pos, since));
+                }
+            }
+
+            /**
+             * @brief This method calls a function for every position whose component was removed since a given tick,
+             * in removal order. A component removed then added again is reported by both each_removal and
+             * each_change.
+             * @tparam Function This template refers to the type of the function, called as f(pos).
+             * @param [in] since This parameter refers to the tick, removals stamped with it are included.
+             * @param [in] f This parameter refers to the function to call.
+             */
+            template<class Function>
+            void each_removal(tick_type since, Function &&f) const
+            {
+                _changes.each_removed(since, std::forward<Function>(f));
+            }
+
+            /**
+             * @brief This method forgets the removals stamped before a given tick, once every consumer of the changes
+             * is past it.
+             * @param [in] until This parameter refers to the tick.
+             */
+            void discard_removals(tick_type until)
+            {
+                _changes.discard(until);
             }
 
             /**
@@ -178,17 +584,119 @@ namespace ecs::containers
              */
             size_type getIndex(value_type const &val) const
             {
-                auto const &it = std::find_if(_data.begin(),  _data.end(), [&val] (value_type const &needle) {
-                    return (std::addressof(val) == std::addressof(needle));
-                });
+                auto const *ptr = std::addressof(val);
+                std::less<value_type const *> less{};
+
+                for (size_type page = 0; page < _pages.size(); ++page) {
+                    if (!_pages[page])
+                        continue;
 
-                if (it == _data.end())
-                    throw std::out_of_range("Value not found");
-                return (it - _data.begin());
+                    auto const *first = _pages[page]->data();
+
+                    if (!less(ptr, first) && less(ptr, first + page_size)) {
+                        const size_type index = page * page_size + static_cast<size_type>(ptr - first);
+
+                        if (index < _size)
+                            return (index);
+                    }
+                }
+                throw std::out_of_range("Value not found");
             }
 
         private :
-            container_type _data{};
+            using pages = page_table<value_type, page_size, Allocator>;
+
+            using word_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<bitset::word_type>;
+
+            pages _pages;
+
+            std::vector<bitset::word_type, word_allocator> _presence;
+
+            change_tracker<page_size, Allocator> _changes;
+
+            size_type _size;
+
+            size_type _count;
+
+            /**
+             * @brief Grows the page table and the presence bitset to cover a given position.
+             */
+            void _cover(size_type pos)
+            {
+                const size_type page = pos / page_size;
+
+                if (page >= _pages.size()) {
+                    _presence.resize((page + 1) * (page_size / bitset::word_bits));
+                    _changes.cover(page + 1);
+                    _pages.resize(page + 1);
+                }
+            }
+
+            template<class PositionIt>
+            [[nodiscard]] static size_type _back(PositionIt first, PositionIt last)
+            {
+                size_type back = 0;
+
+                for (; first != last; ++first)
+                    back = std::max(back, static_cast<size_type>(*first));
+                return (back);
+            }
+
+            [[nodiscard]] reference_type _slot(size_type pos)
+            {
+                const size_type page = pos / page_size;
+
+                _cover(pos);
+                if (!_pages[page])
+                    _changes.allocate(page);
+                return _pages.allocate(page)[pos % page_size];
+            }
+
+            /**
+             * @brief Counts and stamps a component about to be stored in a slot.
+             */
+            void _track(size_type pos, value_type const &slot) noexcept
+            {
+                if (slot.has_value()) {
+                    _changes.changed(pos);
+                } else {
+                    _count++;
+                    _changes.added(pos);
+                }
+            }
+
+            /**
+             * @brief Erases the components of a presence word whose bit is set in a mask.
+             * @return The number of components erased.
+             */
+            size_type _erase_word(size_type word, bitset::word_type mask)
+            {
+                if (mask == 0)
+                    return (0);
+
+                bitset::word_type removed = _presence[word] & mask;
+                size_type erased = 0;
+
+                _presence[word] &= ~removed;
+                for (; removed; removed &= removed - 1, ++erased) {
+                    const size_type pos = word * bitset::word_bits + bitset::lowest_bit(removed);
+
+                    _changes.removed(pos);
+                    (*_pages[pos / page_size])[pos % page_size].reset();
+                }
+                return (erased);
+            }
+
+            void _mark(size_type pos) noexcept
+            {
+                _presence[pos / bitset::word_bits] |= bitset::word_type{1} << (pos % bitset::word_bits);
+            }
+
+            void _grow(size_type pos) noexcept
+            {
+                if (pos >= _size)
+                    _size = pos + 1;
+            }
     };
 }
 
@@ -0,0 +1,161 @@
+#ifndef SPARSE_ARRAY_ITERATOR_HPP
+#define SPARSE_ARRAY_ITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace ecs::iterators
+{
+    /**
+     * @brief This class defines a random access iterator over the elements of a sparse_array, holes included.
+     * @tparam SparseArray This template refers to the sparse_array to iterate over, const qualified for a const
+     * iterator.
+     */
+    template<class SparseArray>
+    class sparse_array_iterator
+    {
+        public:
+            using value_type = typename SparseArray::value_type;
+            using reference = std::conditional_t<std::is_const_v<SparseArray>, value_type const &, value_type &>;
+            using pointer = std::conditional_t<std::is_const_v<SparseArray>, value_type const *, value_type *>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::random_access_iterator_tag;
+            using size_type = typename SparseArray::size_type;
+
+            sparse_array_iterator(SparseArray *array, size_type idx) noexcept :
+                _array(array),
+                _idx(idx)
+            {}
+
+            sparse_array_iterator(sparse_array_iterator const &other) noexcept = default;
+
+            sparse_array_iterator &operator=(sparse_array_iterator const &other) noexcept = default;
+
+            /**
+             * @brief Conversion from an iterator to a const iterator.
+             */
+            template<class Other, class = std::enable_if_t<std::is_same_v<Other const, SparseArray>>>
+            sparse_array_iterator(sparse_array_iterator<Other> const &other) noexcept :
+                _array(other._array),
+                _idx(other._idx)
+            {}
+
+            reference operator*() const
+            {
+                return (*_array)[_idx];
+            }
+
+            pointer operator->() const
+            {
+                return &(*_array)[_idx];
+            }
+
+            reference operator[](difference_type n) const
+            {
+                return (*_array)[_idx + n];
+            }
+
+            sparse_array_iterator &operator++() noexcept
+            {
+                ++_idx;
+                return (*this);
+            }
+
+            sparse_array_iterator operator++(int) noexcept
+            {
+                sparse_array_iterator old = *this;
+
+                ++_idx;
+                return (old);
+            }
+
+            sparse_array_iterator &operator--() noexcept
+            {
+                --_idx;
+                return (*this);
+            }
+
+            sparse_array_iterator operator--(int) noexcept
+            {
+                sparse_array_iterator old = *this;
+
+                --_idx;
+                return (old);
+            }
+
+            sparse_array_iterator &operator+=(difference_type n) noexcept
+            {
+                _idx += n;
+                return (*this);
+            }
+
+            sparse_array_iterator &operator-=(difference_type n) noexcept
+            {
+                _idx -= n;
+                return (*this);
+            }
+
+            friend inline sparse_array_iterator operator+(sparse_array_iterator it, difference_type n) noexcept
+            {
+                return (it += n);
+            }
+
+            friend inline sparse_array_iterator operator+(difference_type n, sparse_array_iterator it) noexcept
+            {
+                return (it += n);
+            }
+
+            friend inline sparse_array_iterator operator-(sparse_array_iterator it, difference_type n) noexcept
+            {
+                return (it -= n);
+            }
+
+            friend inline difference_type operator-(
+                sparse_array_iterator const &lhs,
+                sparse_array_iterator const &rhs) noexcept
+            {
+                return (static_cast<difference_type>(lhs._idx) - static_cast<difference_type>(rhs._idx));
+            }
+
+            friend inline bool operator==(sparse_array_iterator const &lhs, sparse_array_iterator const &rhs) noexcept
+            {
+                return (lhs._idx == rhs._idx);
+            }
+
+            friend inline bool operator!=(sparse_array_iterator const &lhs, sparse_array_iterator const &rhs) noexcept
+            {
+                return (lhs._idx != rhs._idx);
+            }
+
+            friend inline bool operator<(sparse_array_iterator const &lhs, sparse_array_iterator const &rhs) noexcept
+            {
+                return (lhs._idx < rhs._idx);
+            }
+
+            friend inline bool operator>(sparse_array_iterator const &lhs, sparse_array_iterator const &rhs) noexcept
+            {
+                return (lhs._idx > rhs._idx);
+            }
+
+            friend inline bool operator<=(sparse_array_iterator const &lhs, sparse_array_iterator const &rhs) noexcept
+            {
+                return (lhs._idx <= rhs._idx);
+            }
+
+            friend inline bool operator>=(sparse_array_iterator const &lhs, sparse_array_iterator const &rhs) noexcept
+            {
+                return (lhs._idx >= rhs._idx);
+            }
+
+        private:
+            template<class Other>
+            friend class sparse_array_iterator;
+
+            SparseArray *_array;
+
+            size_type _idx;
+    };
+}
+
+#endif //SPARSE_ARRAY_ITERATOR_HPP
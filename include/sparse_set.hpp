@@ -0,0 +1,479 @@
+#ifndef SPARSE_SET_HPP
+#define SPARSE_SET_HPP
+
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include <type_traits>
+
+#include "page_table.hpp"
+
+namespace ecs::containers
+{
+    /**
+     * @brief This class refers to a packed array of Components (sparse set). Components are stored contiguously in a
+     * dense array alongside the index of the entity owning them, and a paged sparse index maps entity indexes to their
+     * position in the dense array. Memory usage and iteration time scale with the number of stored components instead
+     * of the highest entity index.
+     * @warning Erasing a component moves the last component of the dense array in its place: references and iterators
+     * to the last component are invalidated.
+     * @tparam Component This template refers to the type of the component.
+     * @tparam Allocator This template refers to the allocator used for the dense arrays and the sparse index, for
+     * instance a std::pmr::polymorphic_allocator to allocate them from a memory resource (see ecs::pmr).
+     * @tparam Transient This template refers to whether clear() leaves the sparse index untouched (see
+     * transient_set). An entry of the sparse index is then only trusted when the dense array points back to the
+     * entity.
+     */
+    template<typename Component, class Allocator = std::allocator<Component>, bool Transient = false>
+    class sparse_set
+    {
+        public:
+            using component_type = Component;
+
+            using allocator_type = Allocator;
+
+            using value_type = Component;
+
+            using reference_type = value_type &;
+
+            using const_reference_type = value_type const &;
+
+            using container_type = std::vector<value_type, Allocator>;
+
+            using size_type = typename container_type::size_type;
+
+            using iterator = typename container_type::iterator;
+
+            using const_iterator = typename container_type::const_iterator;
+
+            /**
+             * @brief Number of entity indexes covered by a single page of the sparse index.
+             */
+            static constexpr size_type page_size = 4096;
+
+            /**
+             * @brief Value stored in the sparse index for entities that do not own a component.
+             */
+            static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+            sparse_set() :
+                sparse_set(Allocator())
+            {}
+
+            explicit sparse_set(Allocator const &allocator) :
+                _sparse(allocator),
+                _packed(index_allocator(allocator)),
+                _dense(allocator)
+            {}
+
+            sparse_set(sparse_set const &other, Allocator const &allocator) :
+                _sparse(other._sparse, allocator),
+                _packed(other._packed, index_allocator(allocator)),
+                _dense(other._dense, allocator)
+            {}
+
+            sparse_set(sparse_set const &other) :
+                sparse_set(
+                    other,
+                    std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator())
+                )
+            {}
+
+            sparse_set(sparse_set &&other) noexcept = default;
+
+            ~sparse_set() = default;
+
+            /**
+             * @brief The pages and the arrays already allocated are reused (see page_table::operator=).
+             */
+            sparse_set &operator=(sparse_set const &other)
+            {
+                if (this != &other) {
+                    _sparse = other._sparse;
+                    _packed = other._packed;
+                    _dense = other._dense;
+                }
+                return (*this);
+            }
+
+            sparse_set &operator=(sparse_set &&other) noexcept(std::is_nothrow_move_assignable_v<container_type>)
+            {
+                if (this != &other) {
+                    _sparse = std::move(other._sparse);
+                    _packed = std::move(other._packed);
+                    _dense = std::move(other._dense);
+                    other._packed.clear();
+                    other._dense.clear();
+                }
+                return (*this);
+            }
+
+            /**
+             * @brief This method returns the allocator of the sparse_set.
+             */
+            [[nodiscard]] allocator_type get_allocator() const noexcept
+            {
+                return _dense.get_allocator();
+            }
+
+            /**
+             * @brief This method returns the component of the entity at a given position without checking it exists.
+             * @param [in] pos This parameter refers to the index of the entity.
+             */
+            [[nodiscard]] reference_type operator[](size_type pos)
+            {
+                return _dense[_dense_index(pos)];
+            }
+
+            [[nodiscard]] const_reference_type operator[](size_type pos) const
+            {
+                return _dense[_dense_index(pos)];
+            }
+
+            /**
+             * @brief This method returns the component of the entity at a given position.
+             * @param [in] pos This parameter refers to the index of the entity.
+             * @throw If the entity does not own a component, the method throws an std::out_of_range.
+             */
+            [[nodiscard]] reference_type at(size_type pos)
+            {
+                if (!contains(pos))
+                    throw std::out_of_range("Component not found");
+                return _dense[_dense_index(pos)];
+            }
+
+            [[nodiscard]] const_reference_type at(size_type pos) const
+            {
+                if (!contains(pos))
+                    throw std::out_of_range("Component not found");
+                return _dense[_dense_index(pos)];
+            }
+
+            /**
+             * @brief This method returns the component of the entity at a given position without checking it exists.
+             * It is the accessor used by the zippers.
+             * @param [in] pos This parameter refers to the index of the entity.
+             */
+            [[nodiscard]] reference_type get(size_type pos)
+            {
+                return _dense[_dense_index(pos)];
+            }
+
+            [[nodiscard]] const_reference_type get(size_type pos) const
+            {
+                return _dense[_dense_index(pos)];
+            }
+
+            /**
+             * @brief This method checks whether the entity at a given position owns a component.
+             * @param [in] pos This parameter refers to the index of the entity.
+             */
+            [[nodiscard]] bool contains(size_type pos) const noexcept
+            {
+                const size_type page = pos / page_size;
+
+                if (page >= _sparse.size() || !_sparse[page])
+                    return false;
+
+                const size_type index = (*_sparse[page])[pos % page_size];
+
+                if constexpr (Transient)
+                    return index < _packed.size() && _packed[index] == pos;
+                else
+                    return index != npos;
+            }
+
+            /**
+             * @brief This method returns an iterator to the beginning of the dense array of components.
+             */
+            [[nodiscard]] iterator begin()
+            {
+                return _dense.begin();
+            }
+
+            /**
+             * @brief This method returns a const iterator to the beginning of the dense array of components.
+             */
+            [[nodiscard]] const_iterator begin() const
+            {
+                return _dense.begin();
+            }
+
+            /**
+             * @brief This method returns a const iterator to the beginning of the dense array of components.
+             */
+            [[nodiscard]] const_iterator cbegin() const
+            {
+                return _dense.cbegin();
+            }
+
+            /**
+             * @brief This method returns an iterator to the end of the dense array of components.
+             */
+            [[nodiscard]] iterator end()
+            {
+                return _dense.end();
+            }
+
+            /**
+             * @brief This method returns a const iterator to the end of the dense array of components.
+             */
+            [[nodiscard]] const_iterator end() const
+            {
+                return _dense.end();
+            }
+
+            /**
+             * @brief This method returns a const iterator to the end of the dense array of components.
+             */
+            [[nodiscard]] const_iterator cend() const
+            {
+                return _dense.cend();
+            }
+
+            /**
+             * @brief This method returns the index of the entities owning a component, in the same order as the
+             * components returned by begin() and end().
+             */
+            [[nodiscard]] auto const &entities() const noexcept
+            {
+                return _packed;
+            }
+
+            /**
+             * @brief This method returns the number of components stored in the sparse_set.
+             */
+            [[nodiscard]] size_type size() const noexcept
+            {
+                return _dense.size();
+            }
+
+            /**
+             * @brief This method returns the number of components stored in the sparse_set, same as size().
+             */
+            [[nodiscard]] size_type count() const noexcept
+            {
+                return _dense.size();
+            }
+
+            /**
+             * @brief This method checks whether the sparse_set is empty.
+             */
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return _dense.empty();
+            }
+
+            /**
+             * @brief This method returns the number of entity indexes covered by the sparse index. Every entity owning
+             * a component has an index lower than this value.
+             */
+            [[nodiscard]] size_type extent() const noexcept
+            {
+                return _sparse.size() * page_size;
+            }
+
+            /**
+             * @brief This method reserves storage for a given number of components in the dense array.
+             * @param [in] capacity This parameter refers to the number of components to reserve storage for.
+             */
+            void reserve(size_type capacity)
+            {
+                _packed.reserve(capacity);
+                _dense.reserve(capacity);
+            }
+
+            /**
+             * @brief This method removes all components from the sparse_set. Pages of the sparse index are kept, and
+             * left untouched by a transient_set.
+             */
+            void clear() noexcept
+            {
+                if constexpr (!Transient)
+                    for (auto const &page : _sparse)
+                        if (page)
+                            page->fill(npos);
+                _packed.clear();
+                _dense.clear();
+            }
+
+            /**
+             * @brief This method inserts a component into the sparse_set for the entity at a given position and assigns
+             * it a given value.
+             * @param pos The index of the entity.
+             * @param component The value to assign to the component.
+             * @return A reference to the element stored in the sparse_set.
+             */
+            reference_type insert_at(size_type pos, Component const &component)
+            {
+                if (contains(pos))
+                    return (_dense[_dense_index(pos)] = component);
+                _dense.push_back(component);
+                return (_push_entity(pos));
+            }
+
+            /**
+             * @brief This method inserts a component into the sparse_set for the entity at a given position and moves
+             * it a given value.
+             * @param pos The index of the entity.
+             * @param component The value to assign to the component.
+             * @return A reference to the element stored in the sparse_set.
+             */
+            reference_type insert_at(size_type pos, Component &&component)
+            {
+                if (contains(pos))
+                    return (_dense[_dense_index(pos)] = std::forward<Component>(component));
+                _dense.push_back(std::forward<Component>(component));
+                return (_push_entity(pos));
+            }
+
+            /**
+             * @brief This method constructs a component for the entity at a given position.
+             * @tparam Params This variadic template refers to the type of the parameter to pass to the constructor.
+             * @param [in] pos This parameter refers to the index of the entity.
+             * @param [in] parameters This parameter refers to the parameters to pass to the constructor.
+             * @return A reference to the element stored in the sparse_set.
+             */
+            template<class ... Params>
+            reference_type emplace_at(size_type pos, Params &&...parameters)
+            {
+                if (contains(pos))
+                    return (_dense[_dense_index(pos)] = Component(std::forward<Params>(parameters)...));
+                _dense.emplace_back(std::forward<Params>(parameters)...);
+                return (_push_entity(pos));
+            }
+
+            /**
+             * @brief This method assigns values to the components of several entities. Storage is grown once for all
+             * the entities.
+             * @tparam PositionIt This template refers to the type of the forward iterator over the entity indexes.
+             * @tparam ValueIt This template refers to the type of the iterator over the values, use a move_iterator
+             * to move the values.
+             * @param [in] first This parameter refers to the beginning of the entity indexes.
+             * @param [in] last This parameter refers to the end of the entity indexes.
+             * @param [in] values This parameter refers to the beginning of the values, one per entity.
+             */
+            template<class PositionIt, class ValueIt>
+            void insert_range(PositionIt first, PositionIt last, ValueIt values)
+            {
+                _reserve_range(first, last);
+                for (; first != last; ++first, ++values)
+                    insert_at(static_cast<size_type>(*first), *values);
+            }
+
+            /**
+             * @brief This method constructs a component for several entities from the same parameters. Storage is
+             * grown once for all the entities.
+             * @tparam PositionIt This template refers to the type of the forward iterator over the entity indexes.
+             * @tparam Params This variadic template refers to the type of the parameter to pass to the constructor.
+             * @param [in] first This parameter refers to the beginning of the entity indexes.
+             * @param [in] last This parameter refers to the end of the entity indexes.
+             * @param [in] parameters This parameter refers to the parameters to pass to every constructor.
+             */
+            template<class PositionIt, class ... Params>
+            void emplace_n(PositionIt first, PositionIt last, Params const &...parameters)
+            {
+                _reserve_range(first, last);
+                for (; first != last; ++first)
+                    emplace_at(static_cast<size_type>(*first), parameters...);
+            }
+
+            /**
+             * @brief This method erases the component of the entity at a given position. The last component of the
+             * dense array is moved in its place. Does nothing if the entity does not own a component.
+             * @param [in] pos The index of the entity.
+             */
+            void erase(size_type pos)
+            {
+                if (!contains(pos))
+                    return;
+
+                const size_type index = _dense_index(pos);
+                const size_type last = _packed.back();
+
+                if (last != pos) {
+                    _dense[index] = std::move(_dense.back());
+                    _packed[index] = last;
+                    _sparse_slot(last) = index;
+                }
+                _dense.pop_back();
+                _packed.pop_back();
+                _sparse_slot(pos) = npos;
+            }
+
+            /**
+             * @brief This method returns the index of the entity owning a component.
+             * @param [in] val This parameter refers to a component stored in the sparse_set.
+             * @return The index of the entity.
+             * @throw If value is not stored in the sparse_set, method throws an std::out_of_range
+             */
+            size_type getIndex(value_type const &val) const
+            {
+                auto const *ptr = std::addressof(val);
+
+                if (_dense.empty() || ptr < _dense.data() || ptr >= _dense.data() + _dense.size())
+                    throw std::out_of_range("Value not found");
+                return (_packed[static_cast<size_type>(ptr - _dense.data())]);
+            }
+
+        private:
+            using index_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<size_type>;
+
+            page_table<size_type, page_size, Allocator> _sparse;
+
+            std::vector<size_type, index_allocator> _packed;
+
+            container_type _dense;
+
+            [[nodiscard]] size_type _dense_index(size_type pos) const noexcept
+            {
+                return (*_sparse[pos / page_size])[pos % page_size];
+            }
+
+            [[nodiscard]] size_type &_sparse_slot(size_type pos)
+            {
+                const size_type page = pos / page_size;
+
+                if (page >= _sparse.size())
+                    _sparse.resize(page + 1);
+                if (!_sparse[page])
+                    _sparse.allocate(page).fill(npos);
+                return (*_sparse[page])[pos % page_size];
+            }
+
+            template<class PositionIt>
+            void _reserve_range(PositionIt first, PositionIt last)
+            {
+                size_type count = 0;
+                size_type back = 0;
+
+                for (; first != last; ++first, ++count)
+                    back = std::max(back, static_cast<size_type>(*first));
+                if (count == 0)
+                    return;
+                if (_dense.size() + count > _dense.capacity())
+                    reserve(std::max(_dense.size() + count, _dense.capacity() * 2));
+                if (back / page_size >= _sparse.size())
+                    _sparse.resize(back / page_size + 1);
+            }
+
+            reference_type _push_entity(size_type pos)
+            {
+                try {
+                    _sparse_slot(pos) = _packed.size();
+                    _packed.push_back(pos);
+                } catch (...) {
+                    _dense.pop_back();
+                    if (contains(pos))
+                        _sparse_slot(pos) = npos;
+                    throw;
+                }
+                return (_dense.back());
+            }
+    };
+}
+
+#endif //SPARSE_SET_HPP
@@ -0,0 +1,169 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace ecs
+{
+    /**
+     * @brief This class refers to a fixed set of worker threads executing submitted tasks. Every worker owns a task
+     * queue: tasks submitted from a worker go to its own queue, other tasks are spread over the queues, and a worker
+     * whose queue is empty steals tasks from the others.
+     */
+    class thread_pool
+    {
+        public:
+            using task = std::function<void ()>;
+
+            /**
+             * @param [in] workers This parameter refers to the number of worker threads to start.
+             */
+            explicit thread_pool(std::size_t workers = std::thread::hardware_concurrency());
+
+            thread_pool(thread_pool const &other) = delete;
+
+            thread_pool(thread_pool &&other) = delete;
+
+            /**
+             * @brief Waits for the queued tasks to complete then joins the workers.
+             */
+            ~thread_pool();
+
+            thread_pool &operator=(thread_pool const &other) = delete;
+
+            thread_pool &operator=(thread_pool &&other) = delete;
+
+            /**
+             * @brief This method queues a task, it will be executed by the first available worker.
+             * @param [in] t This parameter refers to the task to execute. It must not throw.
+             */
+            void submit(task t);
+
+            /**
+             * @brief This method calls a function over the chunks of a range, in parallel. Chunks are claimed one at a
+             * time by the workers and by the calling thread, so faster threads process more chunks. The method returns
+             * once every chunk has been processed, it may be called from a task running on the pool.
+             * @tparam Function This template refers to the type of the function, called as f(first, last) for each
+             * chunk [first, last).
+             * @param [in] first This parameter refers to the beginning of the range.
+             * @param [in] last This parameter refers to the end of the range.
+             * @param [in] grain This parameter refers to the size of a chunk.
+             * @param [in] f This parameter refers to the function to call.
+             * @throw Rethrows the first exception thrown by the function, once all chunks are processed.
+             */
+            template<class Function>
+            void parallel_for(std::size_t first, std::size_t last, std::size_t grain, Function &&f)
+            {
+                if (first >= last)
+                    return;
+                if (grain == 0)
+                    grain = 1;
+
+                const std::size_t chunks = (last - first + grain - 1) / grain;
+
+                if (chunks == 1) {
+                    f(first, last);
+                    return;
+                }
+
+                auto state = std::make_shared<parallel_state>(first, last, grain, chunks);
+
+                state->body = [&f](std::size_t lo, std::size_t hi) { f(lo, hi); };
+                for (std::size_t i = 0; i < std::min(size(), chunks - 1); ++i)
+                    submit([state] { state->run(); });
+                state->run();
+                state->wait();
+            }
+
+            /**
+             * @brief This method computes the chunk size to use to process a range of entities with parallel_for.
+             * Chunks hold about 16KiB of components so they stay in the L1 cache, are a multiple of 64 entities so
+             * chunk boundaries fall on cache line boundaries, and are small enough to give every thread several chunks
+             * to balance the load.
+             * @param [in] range This parameter refers to the number of entities to process.
+             * @param [in] footprint This parameter refers to the number of bytes of components accessed per entity.
+             */
+            [[nodiscard]] std::size_t chunk_size(std::size_t range, std::size_t footprint) const noexcept;
+
+            /**
+             * @brief This method returns the number of worker threads.
+             */
+            [[nodiscard]] std::size_t size() const noexcept;
+
+            /**
+             * @brief This method returns the index of the worker calling it, or size() if the calling thread is not a
+             * worker of the pool. It tells the data owned by each thread apart (see registry::commands).
+             */
+            [[nodiscard]] std::size_t current_worker() const noexcept;
+
+        private:
+            struct worker_queue
+            {
+                std::mutex mutex{};
+
+                std::deque<task> tasks{};
+            };
+
+            /**
+             * @brief Shared state of a parallel_for. Workers starting after the last chunk was claimed only read the
+             * chunk counter, so the state outlives the call but the body is never used once it returned.
+             */
+            struct parallel_state
+            {
+                std::function<void (std::size_t, std::size_t)> body{};
+
+                std::size_t first;
+
+                std::size_t last;
+
+                std::size_t grain;
+
+                std::size_t chunks;
+
+                std::atomic<std::size_t> next{0};
+
+                std::size_t done{0};
+
+                std::exception_ptr error{};
+
+                std::mutex mutex{};
+
+                std::condition_variable finished{};
+
+                parallel_state(std::size_t first, std::size_t last, std::size_t grain, std::size_t chunks) noexcept;
+
+                void run() noexcept;
+
+                void wait();
+            };
+
+            std::vector<std::unique_ptr<worker_queue>> _queues;
+
+            std::vector<std::thread> _workers;
+
+            std::atomic<std::size_t> _next;
+
+            std::size_t _pending;
+
+            std::mutex _mutex;
+
+            std::condition_variable _condition;
+
+            bool _stopping;
+
+            void _work(std::size_t index);
+
+            bool _pop(std::size_t index, task &t);
+    };
+}
+
+#endif //THREAD_POOL_HPP
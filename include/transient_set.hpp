@@ -0,0 +1,24 @@
+#ifndef TRANSIENT_SET_HPP
+#define TRANSIENT_SET_HPP
+
+#include <memory>
+
+#include "sparse_set.hpp"
+
+namespace ecs::containers
+{
+    /**
+     * @brief This alias refers to a sparse set meant for components living a single frame (events, commands...).
+     * Registered in a registry, it is cleared once every system has run (see registry::run_systems). Unlike
+     * sparse_set, the sparse index is never reset: an entry is only trusted when the dense array points back to the
+     * entity, so clear() only drops the dense arrays. It is O(1) for trivially destructible components, otherwise it
+     * runs one destructor per component. The dense arrays keep their capacity from frame to frame: once the storage
+     * reached the peak number of components per frame, adding and clearing components allocates nothing.
+     * @tparam Component This template refers to the type of the component.
+     * @tparam Allocator This template refers to the allocator used for the dense arrays and the sparse index.
+     */
+    template<typename Component, class Allocator = std::allocator<Component>>
+    using transient_set = sparse_set<Component, Allocator, true>;
+}
+
+#endif //TRANSIENT_SET_HPP
@@ -5,37 +5,63 @@
 #define NOMINMAX
 #endif 
 
+#include <tuple>
+#include <limits>
 #include <algorithm>
-#include "is_sparse_array.hpp"
+#include "is_soa_array.hpp"
+#include "is_sparse_set.hpp"
+#include "thread_pool.hpp"
 #include "zipper_iterator.hpp"
 
 namespace ecs::containers
 {
+    template<class ... T>
+    class indexed_zipper;
+
     /**
      * @brief Class that allows you to instantiate iterators over components. Iterator will iterate over all entity
-     * that has ALL components. If one component is missing form the entity, the latter will be skipped.
-     * @warning If any of the sparse_array is resized (add entity, add component to an entity that has an index greater
-     * than the size of the sparse_array, etc...) the zipper and all its iterators are invalided. (if you continue using
-     * it, the behavior is \b UNDEFINED and crashes / \b SIGSEGV may occur).
-     * @tparam Containers This template parameter refers to the components you want to iterate over.
+     * that has ALL components. If one component is missing form the entity, the latter will be skipped. The container
+     * holding the fewest components drives the iteration and the others are probed, so the cost of the iteration
+     * scales with the smallest container. Entities are visited in index order unless a sparse_set drives the
+     * iteration, in which case they are visited in the order of its dense array. A container wrapped in exclude skips
+     * the entities owning a component in it, a container wrapped in maybe returns a pointer to the component or
+     * nullptr (only required containers drive the iteration):
+     * @code
+     * for (auto &&[pos, vel, sprite] : zipper(positions, velocities, exclude(frozen), maybe(sprites)))
+     * @endcode
+     * @warning The range of entities iterated over is computed when the zipper is built: components added afterwards
+     * to an entity with a greater index are not visited. A reference to a component stored in a sparse_set is
+     * invalidated when the sparse_set grows or when a component is erased from it, and components must not be erased
+     * from a sparse_set driving the iteration.
+     * @tparam Containers This template parameter refers to the components you want to iterate over, as containers or
+     * containers wrapped in exclude or maybe.
      */
     template<class ... Containers>
     class zipper
     {
-        static_assert((assertion::is_sparse_array_v<Containers> && ...), "Containers must be sparse_array.");
+        static_assert(
+            ((assertion::has_presence_v<zipper_container_t<Containers>> ||
+            assertion::is_sparse_set_v<zipper_container_t<Containers>>) && ...),
+            "Containers must be sparse_array, soa_array or sparse_set."
+        );
+
+        static_assert((assertion::is_required_v<Containers> || ...), "At least one container must be required.");
 
         public:
             using iterator = iterators::zipper_iterator<Containers ...>;
-            using iterator_tuple = typename iterator::iterator_tuple;
+            using container_tuple = typename iterator::container_tuple;
+
+            friend indexed_zipper<Containers ...>;
 
             /**
              * @param [in | out] cs This parameter refers to the sparse_array containing the component you specified in
              * template.
              */
-            explicit zipper(Containers &... cs) :
-                _size(_computeSize(cs...)),
-                _begin(cs.begin()...),
-                _end(_compute_end(cs..., _size))
+            explicit zipper(zipper_parameter_t<Containers>... cs) :
+                _containers(zipper_pointer<Containers>(cs)...),
+                _driver(_selectDriver(_seq)),
+                _size(_slotCount(_seq)),
+                _dense(_denseJoin(_seq))
             {}
 
             /**
@@ -44,7 +70,7 @@ namespace ecs::containers
              */
             [[nodiscard]] iterator begin() noexcept
             {
-                return iterator(_begin, _size);
+                return iterator(_containers, _driver, _dense, 0, _size);
             }
 
             /**
@@ -53,28 +79,105 @@ namespace ecs::containers
              */
             [[nodiscard]] iterator end() noexcept
             {
-                return iterator(_end, 0);
+                return iterator(_containers, _driver, _dense, _size, _size);
+            }
+
+            /**
+             * @brief This method calls a function for every entity that has ALL components, in parallel. The slots of
+             * the container driving the iteration are split into chunks sized after the components footprint (see
+             * thread_pool::chunk_size), which are processed concurrently by the workers of the pool and the calling
+             * thread.
+             * @warning The function must only access the components of the entity it is called for.
+             * @tparam Function This template refers to the type of the function, called as f(components...).
+             * @param [in] pool This parameter refers to the thread_pool to run the function on.
+             * @param [in] f This parameter refers to the function to call.
+             */
+            template<class Function>
+            void par_each(thread_pool &pool, Function &&f)
+            {
+                _parallel(pool, [&f](iterator &it) {
+                    std::apply(f, *it);
+                });
             }
 
         private:
+            container_tuple _containers;
+
+            size_t _driver;
+
             size_t _size;
 
-            iterator_tuple _begin;
+            bool _dense;
 
-            iterator_tuple _end;
+            static constexpr std::index_sequence_for<Containers ...> _seq{};
 
-            [[nodiscard]] static size_t _computeSize(Containers &... containers)
+            template<class Function>
+            void _parallel(thread_pool &pool, Function &&f)
             {
-                return (std::min)(
-                    { containers.size()... }
-               );
+                constexpr std::size_t footprint = (sizeof(typename zipper_container_t<Containers>::value_type) + ...);
+
+                pool.parallel_for(0, _size, pool.chunk_size(_size, footprint), [this, &f](size_t first, size_t last) {
+                    iterator end(_containers, _driver, _dense, last, last);
+
+                    for (iterator it(_containers, _driver, _dense, first, last); it != end; ++it)
+                        f(it);
+                });
             }
 
-            [[nodiscard]] static iterator_tuple _compute_end(Containers &... containers, std::size_t minSize)
+            template<size_t ... Is>
+            [[nodiscard]] size_t _selectDriver(std::index_sequence<Is ...>) const noexcept
             {
-                return std::tuple((containers.begin() + minSize)...);
+                size_t driver = 0;
+                size_t best = std::numeric_limits<size_t>::max();
+
+                ((assertion::is_required_v<Containers> && std::get<Is>(_containers)->count() < best ?
+                    (void) (best = std::get<Is>(_containers)->count(), driver = Is) :
+                    (void) 0), ...);
+                return (driver);
+            }
+
+            /**
+             * @brief Computes the number of slots of the driver to walk. A sparse_array driver is bounded by the
+             * smallest required sparse_array, as no entity past its size owns every component.
+             */
+            template<size_t ... Is>
+            [[nodiscard]] size_t _slotCount(std::index_sequence<Is ...>) const noexcept
+            {
+                size_t size = 0;
+                size_t bound = std::numeric_limits<size_t>::max();
+
+                ((assertion::is_required_v<Containers> && assertion::has_presence_v<zipper_container_t<Containers>> ?
+                    (void) (bound = (std::min)(bound, std::get<Is>(_containers)->size())) :
+                    (void) 0), ...);
+                ((Is == _driver ? (void) (size = _slots(*std::get<Is>(_containers), bound)) : (void) 0), ...);
+                return (size);
+            }
+
+            /**
+             * @brief Tells whether the driver holds at least one component per bitset word of the slots to walk. Only
+             * such dense joins intersect the presence bitsets, a sparse one walks the few components of its driver.
+             */
+            template<size_t ... Is>
+            [[nodiscard]] bool _denseJoin(std::index_sequence<Is ...>) const noexcept
+            {
+                size_t count = 0;
+
+                ((Is == _driver ? (void) (count = std::get<Is>(_containers)->count()) : (void) 0), ...);
+                return (count >= _size / bitset::word_bits);
+            }
+
+            template<class Container>
+            [[nodiscard]] static size_t _slots(Container const &container, size_t bound) noexcept
+            {
+                if constexpr (assertion::is_sparse_set_v<Container>)
+                    return container.count();
+                else
+                    return (std::min)(bound, container.size());
             }
     };
+
+    template<class ... Args>
+    zipper(Args &&...) -> zipper<std::remove_reference_t<Args>...>;
 }
 
 #endif //ZIPPER_HPP
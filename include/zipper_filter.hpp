@@ -0,0 +1,147 @@
+#ifndef ZIPPER_FILTER_HPP
+#define ZIPPER_FILTER_HPP
+
+#include <tuple>
+#include <type_traits>
+
+namespace ecs::containers
+{
+    /**
+     * @brief This class wraps a container passed to a zipper to skip the entities owning a component in it. The
+     * container is not part of the tuples returned by the zipper.
+     * @code
+     * for (auto &&[pos, vel] : ecs::containers::zipper(positions, velocities, ecs::containers::exclude(frozen)))
+     * @endcode
+     * When every other container is a sparse_array, an excluded sparse_array is removed from the presence bitsets
+     * intersection, many positions at a time, instead of being probed for every entity.
+     * @tparam Container This template refers to the type of the container (sparse_array, sparse_set or transient_set).
+     */
+    template<class Container>
+    class exclude
+    {
+        public:
+            using container_type = Container;
+
+            explicit exclude(Container &container) noexcept :
+                _container(&container)
+            {}
+
+            [[nodiscard]] Container &container() const noexcept
+            {
+                return (*_container);
+            }
+
+        private:
+            Container *_container;
+    };
+
+    /**
+     * @brief This class wraps a container passed to a zipper to return its component when the entity owns one,
+     * without requiring it. The zipper returns a pointer to the component, or nullptr.
+     * @tparam Container This template refers to the type of the container (sparse_array, sparse_set or transient_set).
+     */
+    template<class Container>
+    class maybe
+    {
+        public:
+            using container_type = Container;
+
+            explicit maybe(Container &container) noexcept :
+                _container(&container)
+            {}
+
+            [[nodiscard]] Container &container() const noexcept
+            {
+                return (*_container);
+            }
+
+        private:
+            Container *_container;
+    };
+}
+
+namespace ecs::assertion
+{
+    template<class T>
+    struct is_exclude : std::false_type {};
+
+    template<class Container>
+    struct is_exclude<containers::exclude<Container>> : std::true_type {};
+
+    template<class T>
+    constexpr inline bool is_exclude_v = is_exclude<T>::value;
+
+    template<class T>
+    struct is_maybe : std::false_type {};
+
+    template<class Container>
+    struct is_maybe<containers::maybe<Container>> : std::true_type {};
+
+    template<class T>
+    constexpr inline bool is_maybe_v = is_maybe<T>::value;
+
+    /**
+     * @brief True when a zipper argument is a container the entities must own a component in, that is neither
+     * excluded nor optional.
+     */
+    template<class T>
+    constexpr inline bool is_required_v = !is_exclude_v<T> && !is_maybe_v<T>;
+}
+
+namespace ecs::containers
+{
+    /**
+     * @brief The zipper_argument struct maps a template argument of a zipper to the container it iterates over and
+     * to the matching parameter of the constructor of the zipper.
+     */
+    template<class T>
+    struct zipper_argument
+    {
+        using container_type = T;
+
+        using parameter_type = T &;
+    };
+
+    template<class Container>
+    struct zipper_argument<exclude<Container>>
+    {
+        using container_type = Container;
+
+        using parameter_type = exclude<Container>;
+    };
+
+    template<class Container>
+    struct zipper_argument<maybe<Container>>
+    {
+        using container_type = Container;
+
+        using parameter_type = maybe<Container>;
+    };
+
+    /**
+     * @brief Type of the container a zipper template argument iterates over.
+     */
+    template<class T>
+    using zipper_container_t = typename zipper_argument<T>::container_type;
+
+    /**
+     * @brief Type of the parameter of the constructor of a zipper for a template argument: a reference to a
+     * container, or a filter.
+     */
+    template<class T>
+    using zipper_parameter_t = typename zipper_argument<T>::parameter_type;
+
+    /**
+     * @brief This function returns the pointer stored for an argument of a zipper.
+     */
+    template<class T>
+    [[nodiscard]] zipper_container_t<T> *zipper_pointer(zipper_parameter_t<T> arg) noexcept
+    {
+        if constexpr (assertion::is_required_v<T>)
+            return (&arg);
+        else
+            return (&arg.container());
+    }
+}
+
+#endif //ZIPPER_FILTER_HPP
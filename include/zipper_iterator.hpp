@@ -2,7 +2,15 @@
 #define ZIPPER_ITERATOR_HPP
 
 #include <tuple>
+#include <utility>
+#include <iterator>
 #include <optional>
+#include <type_traits>
+
+#include "bitset.hpp"
+#include "is_soa_array.hpp"
+#include "is_sparse_set.hpp"
+#include "zipper_filter.hpp"
 
 namespace ecs::containers
 {
@@ -12,52 +20,72 @@ namespace ecs::containers
 
 namespace ecs::iterators
 {
+    template<class ...T>
+    class indexed_zipper_iterator;
+
+    template<class Container>
+    using it_reference_t = decltype(std::declval<Container &>().get(0));
+
+    /**
+     * @brief The zipper_element struct holds the elements returned by a zipper_iterator for one of its template
+     * arguments: a reference to the component, nothing for an excluded container, a pointer to the component or
+     * nullptr for an optional one. Containers handing out proxies (soa_array) give an optional proxy instead.
+     */
+    template<class T>
+    struct zipper_element
+    {
+        using type = std::tuple<it_reference_t<T>>;
+    };
+
+    template<class Container>
+    struct zipper_element<containers::exclude<Container>>
+    {
+        using type = std::tuple<>;
+    };
+
+    template<class Container>
+    struct zipper_element<containers::maybe<Container>>
+    {
+        using type = std::tuple<std::conditional_t<
+            std::is_reference_v<it_reference_t<Container>>,
+            std::remove_reference_t<it_reference_t<Container>> *,
+            std::optional<it_reference_t<Container>>
+        >>;
+    };
+
     /**
      * @brief This class defines an iterator instantiated by the zipper class. it's intended to be used in a range based
-     * loop or a simple for.
+     * loop or a simple for. The iterator walks the slots of a single container, the driver, and probes the other
+     * containers for the entity stored in each slot. The slots of a sparse_set are the positions of its dense array,
+     * the slots of a sparse_array are its positions. Excluded containers must not hold the entity and optional ones are
+     * not probed until dereferenced (see containers::exclude and containers::maybe). When every required and excluded
+     * container is a sparse_array or a soa_array and the driver holds at least one entity per 64 positions, their
+     * presence bitsets are intersected instead, many positions at a time.
      * @tparam Containers This variadic template refers to the types to bind the iterator.
      */
     template<class ...Containers>
     class zipper_iterator
     {
-            template<class Container>
-            using iterator_t = typename Container::iterator;
-
-            template<class Container>
-            using it_reference_t = decltype(std::declval<typename iterator_t<Container>::reference>().value());
-
         public:
-            using value_type = std::tuple<it_reference_t<Containers>...>;
+            using value_type = decltype(std::tuple_cat(std::declval<typename zipper_element<Containers>::type>()...));
             using reference = value_type &;
             using pointer = void;
             using difference_type = std::size_t;
             using iterator_category = std::input_iterator_tag;
-            using iterator_tuple = std::tuple<iterator_t<Containers>...>;
+            using container_tuple = std::tuple<containers::zipper_container_t<Containers> *...>;
 
             friend ecs::containers::zipper<Containers ...>;
+            friend indexed_zipper_iterator<Containers ...>;
 
-            zipper_iterator(zipper_iterator const &z) noexcept :
-                _max(z._max),
-                _idx(z._idx),
-                _current(z._current)
-            {}
+            zipper_iterator(zipper_iterator const &z) noexcept = default;
 
-            const zipper_iterator &operator++() //TODO fix this magic
+            zipper_iterator &operator=(zipper_iterator const &z) noexcept = default;
+
+            const zipper_iterator &operator++()
             {
-                if (_max == 0)
-                    return (*this);
-                if (_idx == _max - 1) {
-                    _incrAll(_seq);
-                    _idx++;
-                }
-                else if (_idx < _max - 1)
-                    do {
-                        _incrAll(_seq);
-                        _idx += 1;
-                    } while (!_allSet(_seq) && _idx < _max - 1);
-                if (_idx == _max - 1 && !_allSet(_seq)) {
-                    _incrAll(_seq);
-                    _idx++;
+                if (_slot < _last) {
+                    ++_slot;
+                    _advance(*this);
                 }
                 return (*this);
             }
@@ -79,50 +107,206 @@ namespace ecs::iterators
                 return (_toValue(_seq));
             }
 
+            /**
+             * @brief This method returns the index of the entity the iterator refers to.
+             */
+            [[nodiscard]] std::size_t index() const noexcept
+            {
+                return (_idx);
+            }
+
             friend inline bool operator==(zipper_iterator const &lhs, zipper_iterator const &rhs)
             {
-                return ((lhs._max - lhs._idx) == (rhs._max - rhs._idx));
+                return (lhs._slot == rhs._slot);
             }
 
             friend inline bool operator!=(zipper_iterator const &lhs, zipper_iterator const &rhs)
             {
-                return ((lhs._max - lhs._idx) != (rhs._max - rhs._idx));
+                return (lhs._slot != rhs._slot);
             }
 
         private:
+            using advance_function = void (*)(zipper_iterator &);
 
-            iterator_tuple _current;
+            container_tuple _containers;
 
-            std::size_t _max;
+            advance_function _advance;
 
-            std::size_t _idx{};
+            std::size_t _last;
+
+            std::size_t _slot;
+
+            std::size_t _idx;
 
             static constexpr std::index_sequence_for<Containers ...> _seq{};
 
-            template<size_t ... Is>
-            void _incrAll(std::index_sequence<Is ...>)
+            /**
+             * @brief Moves the iterator to the first slot of the driver, starting at the current one, whose entity
+             * owns a component in every other container.
+             * @tparam Driver This template refers to the position of the driver in the containers.
+             */
+            template<std::size_t Driver>
+            static void _advanceWith(zipper_iterator &it)
             {
-                ((++std::get<Is>(_current)), ...);
+                using driver_type = containers::zipper_container_t<
+                    std::tuple_element_t<Driver, std::tuple<Containers...>>
+                >;
+                auto const &driver = *std::get<Driver>(it._containers);
+
+                for (; it._slot < it._last; ++it._slot) {
+                    if constexpr (assertion::is_sparse_set_v<driver_type>) {
+                        it._idx = driver.entities()[it._slot];
+                    } else {
+                        it._slot = driver.next(it._slot);
+                        if (it._slot >= it._last)
+                            break;
+                        it._idx = it._slot;
+                    }
+                    if (it.template _allSet<Driver>(_seq))
+                        return;
+                }
+                it._slot = it._last;
             }
 
-            template<size_t ... Is>
-            [[nodiscard]] bool _allSet(std::index_sequence<Is ...>)
+            /**
+             * @brief Moves the iterator to the first position, starting at the current one, set in the presence
+             * bitset of every required container and in none of the excluded ones.
+             */
+            static void _advanceIntersection(zipper_iterator &it)
             {
-                return (((*std::get<Is>(_current)) != std::nullopt) && ...);
+                constexpr std::size_t required = (0 + ... + assertion::is_required_v<Containers>);
+                constexpr std::size_t excluded = (0 + ... + assertion::is_exclude_v<Containers>);
+                std::array<bitset::word_type const *, required> bitsets{};
+                std::array<bitset::word_type const *, excluded> excludedBitsets{};
+                std::array<std::size_t, excluded> excludedWords{};
+
+                it._presence(bitsets, excludedBitsets, excludedWords, _seq);
+                it._slot = bitset::find_first(bitsets, excludedBitsets, excludedWords, it._slot, it._last);
+                it._idx = it._slot;
+            }
+
+            template<std::size_t N, std::size_t M, size_t ... Is>
+            void _presence(
+                std::array<bitset::word_type const *, N> &bitsets,
+                std::array<bitset::word_type const *, M> &excluded,
+                std::array<std::size_t, M> &excludedWords,
+                std::index_sequence<Is ...>) const noexcept
+            {
+                std::size_t n = 0;
+                std::size_t m = 0;
+
+                ((assertion::is_required_v<Containers> ?
+                    (void) (bitsets[n++] = _bitset<Containers>(std::get<Is>(_containers))) :
+                    assertion::is_exclude_v<Containers> ?
+                    (void) (excludedWords[m] = _bitsetWords<Containers>(std::get<Is>(_containers)),
+                        excluded[m++] = _bitset<Containers>(std::get<Is>(_containers))) :
+                    (void) 0), ...);
+            }
+
+            /**
+             * @brief Returns the presence bitset of a container, or nullptr for an optional container, whose presence
+             * is not used.
+             */
+            template<class T, class Container>
+            [[nodiscard]] static bitset::word_type const *_bitset(Container const *container) noexcept
+            {
+                if constexpr (assertion::is_maybe_v<T>)
+                    return (nullptr);
+                else
+                    return (container->presence().data());
+            }
+
+            template<class T, class Container>
+            [[nodiscard]] static std::size_t _bitsetWords(Container const *container) noexcept
+            {
+                if constexpr (assertion::is_maybe_v<T>)
+                    return (0);
+                else
+                    return (container->presence().size());
+            }
+
+            template<std::size_t Driver, size_t ... Is>
+            [[nodiscard]] bool _allSet(std::index_sequence<Is ...>) const
+            {
+                return (_accepts<Containers>(Is == Driver, std::get<Is>(_containers)) && ...);
+            }
+
+            /**
+             * @brief Tells whether the entity of the iterator passes the filter of a container.
+             */
+            template<class T, class Container>
+            [[nodiscard]] bool _accepts(bool driver, Container const *container) const
+            {
+                if constexpr (assertion::is_exclude_v<T>)
+                    return (!container->contains(_idx));
+                else if constexpr (assertion::is_maybe_v<T>)
+                    return (true);
+                else
+                    return (driver || container->contains(_idx));
             }
 
             template<size_t ... Is>
             [[nodiscard]] value_type _toValue(std::index_sequence<Is ...>)
             {
-                return std::tie(std::get<Is>(_current)->value()...);
+                return (std::tuple_cat(_element<Containers>(std::get<Is>(_containers))...));
+            }
+
+            template<class T, class Container>
+            [[nodiscard]] typename zipper_element<T>::type _element(Container *container)
+            {
+                if constexpr (assertion::is_exclude_v<T>)
+                    return {};
+                else if constexpr (assertion::is_maybe_v<T> && !std::is_reference_v<it_reference_t<Container>>)
+                    return (typename zipper_element<T>::type(
+                        container->contains(_idx) ? std::make_optional(container->get(_idx)) : std::nullopt
+                    ));
+                else if constexpr (assertion::is_maybe_v<T>)
+                    return (typename zipper_element<T>::type(
+                        container->contains(_idx) ? &container->get(_idx) : nullptr
+                    ));
+                else
+                    return (typename zipper_element<T>::type(container->get(_idx)));
+            }
+
+            /**
+             * @brief Returns the advance function driven by a container, only required containers drive.
+             */
+            template<std::size_t I, class T>
+            [[nodiscard]] static advance_function _driverAdvance() noexcept
+            {
+                if constexpr (assertion::is_required_v<T>)
+                    return (&zipper_iterator::_advanceWith<I>);
+                else
+                    return (nullptr);
+            }
+
+            template<size_t ... Is>
+            [[nodiscard]] static advance_function _advanceFunction(
+                std::size_t driver, bool dense, std::index_sequence<Is ...>)
+            {
+                advance_function f = nullptr;
+
+                if constexpr ((
+                    (assertion::is_maybe_v<Containers> ||
+                    assertion::has_presence_v<containers::zipper_container_t<Containers>>) && ...)) {
+                    if (dense)
+                        return (&zipper_iterator::_advanceIntersection);
+                } else {
+                    (void) dense;
+                }
+                ((f = Is == driver ? _driverAdvance<Is, Containers>() : f), ...);
+                return (f);
             }
 
-            zipper_iterator(iterator_tuple const &it_tuple, std::size_t max) :
-                _current(it_tuple),
-                _max(max)
+            zipper_iterator(
+                container_tuple const &containers, std::size_t driver, bool dense, std::size_t slot, std::size_t last) :
+                _containers(containers),
+                _advance(_advanceFunction(driver, dense, _seq)),
+                _last(last),
+                _slot(slot),
+                _idx(0)
             {
-                if (_max > 0 && !_allSet(_seq))
-                    this->operator++();
+                _advance(*this);
             }
     };
 }
@@ -0,0 +1,200 @@
+#include <algorithm>
+
+#include "archetype_registry.hpp"
+
+namespace ecs
+{
+    archetype_registry::archetype_registry() :
+        _tables{},
+        _tableIndex{},
+        _locations{},
+        _systems{},
+        _entities{}
+    {
+        _tables.emplace_back(std::make_unique<table>());
+        _tableIndex.emplace(std::vector<std::size_t>{}, 0);
+    }
+
+    archetype_registry::archetype_registry(archetype_registry const &other) :
+        _tables{},
+        _tableIndex(other._tableIndex),
+        _locations(other._locations),
+        _systems(other._systems),
+        _entities(other._entities)
+    {
+        _tables.reserve(other._tables.size());
+        for (auto const &t : other._tables) {
+            auto copy = std::make_unique<table>();
+
+            copy->type = t->type;
+            copy->columnOf = t->columnOf;
+            copy->entities = t->entities;
+            copy->addEdges = t->addEdges;
+            copy->removeEdges = t->removeEdges;
+            copy->columns.reserve(t->columns.size());
+            for (auto const &c : t->columns)
+                copy->columns.emplace_back(c->clone());
+            _tables.emplace_back(std::move(copy));
+        }
+    }
+
+    archetype_registry &archetype_registry::operator=(archetype_registry const &other)
+    {
+        if (this != &other)
+            *this = archetype_registry(other);
+        return *this;
+    }
+
+    entity archetype_registry::spawn_entity()
+    {
+        const entity e = _entities.spawn();
+
+        _place(e);
+        return e;
+    }
+
+    entity archetype_registry::entity_from_index(std::size_t index)
+    {
+        const entity e = _entities.spawn_at(index);
+
+        _place(e);
+        return e;
+    }
+
+    void archetype_registry::kill_entity(entity const &e) noexcept
+    {
+        if (!_entities.valid(e))
+            return;
+
+        const location at = _locations[e.index()];
+
+        _remove_row(at.table, at.row);
+        _entities.kill(e);
+    }
+
+    bool archetype_registry::valid(entity const &e) const noexcept
+    {
+        return _entities.valid(e);
+    }
+
+    void archetype_registry::run_systems(double deltaTime)
+    {
+        for (auto const &system : _systems)
+            system(*this, deltaTime);
+    }
+
+    archetype_registry::location archetype_registry::_location(entity const &e) const
+    {
+        if (!_entities.valid(e))
+            throw std::out_of_range("Entity not alive");
+        return _locations[e.index()];
+    }
+
+    void archetype_registry::_place(entity const &e)
+    {
+        try {
+            if (e.index() >= _locations.size())
+                _locations.resize(e.index() + 1);
+            _tables[0]->entities.push_back(e);
+        } catch (...) {
+            _entities.kill(e);
+            throw;
+        }
+        _locations[e.index()] = { 0, _tables[0]->entities.size() - 1 };
+    }
+
+    void archetype_registry::_move(entity const &e, std::size_t to)
+    {
+        const location from = _locations[e.index()];
+        table &source = *_tables[from.table];
+        table &destination = *_tables[to];
+        std::size_t moved = 0;
+
+        try {
+            for (; moved < destination.type.size(); ++moved)
+                if (auto *c = source.column(destination.type[moved]))
+                    destination.columns[moved]->push_from(*c, from.row);
+            destination.entities.push_back(e);
+        } catch (...) {
+            for (std::size_t i = 0; i < moved; ++i)
+                if (source.column(destination.type[i]))
+                    destination.columns[i]->pop_back();
+            throw;
+        }
+        _remove_row(from.table, from.row);
+        _locations[e.index()] = { to, destination.entities.size() - 1 };
+    }
+
+    void archetype_registry::_remove_row(std::size_t t, std::size_t row) noexcept
+    {
+        table &source = *_tables[t];
+
+        for (auto &c : source.columns)
+            c->swap_remove(row);
+        if (row + 1 != source.entities.size()) {
+            source.entities[row] = source.entities.back();
+            _locations[source.entities[row].index()].row = row;
+        }
+        source.entities.pop_back();
+    }
+
+    std::size_t archetype_registry::_table_with(std::size_t from, std::size_t id, column_factory make)
+    {
+        auto const edge = _tables[from]->addEdges.find(id);
+
+        if (edge != _tables[from]->addEdges.end())
+            return edge->second;
+
+        std::vector<std::size_t> type = _tables[from]->type;
+
+        type.insert(std::lower_bound(type.begin(), type.end(), id), id);
+
+        const std::size_t to = _table(type, *_tables[from], id, make);
+
+        _tables[from]->addEdges.emplace(id, to);
+        _tables[to]->removeEdges.emplace(id, from);
+        return to;
+    }
+
+    std::size_t archetype_registry::_table_without(std::size_t from, std::size_t id)
+    {
+        auto const edge = _tables[from]->removeEdges.find(id);
+
+        if (edge != _tables[from]->removeEdges.end())
+            return edge->second;
+
+        std::vector<std::size_t> type = _tables[from]->type;
+
+        type.erase(std::lower_bound(type.begin(), type.end(), id));
+
+        const std::size_t to = _table(type, *_tables[from], id, nullptr);
+
+        _tables[from]->removeEdges.emplace(id, to);
+        _tables[to]->addEdges.emplace(id, from);
+        return to;
+    }
+
+    std::size_t archetype_registry::_table(
+        std::vector<std::size_t> const &type,
+        table const &from,
+        std::size_t id,
+        column_factory make)
+    {
+        auto const found = _tableIndex.find(type);
+
+        if (found != _tableIndex.end())
+            return found->second;
+
+        auto created = std::make_unique<table>();
+
+        created->type = type;
+        created->columnOf.assign(type.empty() ? 0 : type.back() + 1, npos);
+        for (std::size_t i = 0; i < type.size(); ++i) {
+            created->columnOf[type[i]] = i;
+            created->columns.emplace_back(type[i] == id ? make() : from.column(type[i])->empty());
+        }
+        _tables.emplace_back(std::move(created));
+        _tableIndex.emplace(type, _tables.size() - 1);
+        return _tables.size() - 1;
+    }
+}
@@ -0,0 +1,50 @@
+#include "command_buffer.hpp"
+#include "registry.hpp"
+
+namespace ecs
+{
+    command_buffer::command_buffer() noexcept :
+        _queues{},
+        _kills{}
+    {}
+
+    command_buffer::command_buffer(command_buffer const &) noexcept :
+        _queues{},
+        _kills{}
+    {}
+
+    void command_buffer::kill(entity const &e)
+    {
+        _kills.push_back(e);
+    }
+
+    bool command_buffer::empty() const noexcept
+    {
+        for (auto const &queue : _queues)
+            if (queue && !queue->empty())
+                return false;
+        return _kills.empty();
+    }
+
+    void command_buffer::clear() noexcept
+    {
+        for (auto &queue : _queues)
+            if (queue)
+                queue->clear();
+        _kills.clear();
+    }
+
+    void command_buffer::play(registry &r)
+    {
+        try {
+            for (auto &queue : _queues)
+                if (queue && !queue->empty())
+                    queue->play(r);
+            r.kill_entities(_kills);
+        } catch (...) {
+            clear();
+            throw;
+        }
+        clear();
+    }
+}
@@ -0,0 +1,13 @@
+#include <atomic>
+
+#include "component_id.hpp"
+
+namespace ecs
+{
+    std::size_t component_id::_next() noexcept
+    {
+        static std::atomic<std::size_t> next{0};
+
+        return next++;
+    }
+}
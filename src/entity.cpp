@@ -2,9 +2,19 @@
 
 ecs::entity::operator std::size_t() const noexcept
 {
-    return _id;
+    return index();
 }
 
-ecs::entity::entity(std::size_t id) noexcept :
-    _id(id)
+ecs::entity::index_type ecs::entity::index() const noexcept
+{
+    return static_cast<index_type>(_id);
+}
+
+ecs::entity::generation_type ecs::entity::generation() const noexcept
+{
+    return static_cast<generation_type>(_id >> 32);
+}
+
+ecs::entity::entity(index_type index, generation_type generation) noexcept :
+    _id((static_cast<std::uint64_t>(generation) << 32) | index)
 {}
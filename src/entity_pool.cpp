@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "entity_pool.hpp"
+#include "snapshot.hpp"
+#include "exceptions/invalid_entity_exception.hpp"
+
+namespace ecs
+{
+    entity_pool::entity_pool() noexcept :
+        _slots{},
+        _prev{},
+        _freeHead(_null),
+        _freeCount(0),
+        _reserved{}
+    {}
+
+    entity entity_pool::spawn()
+    {
+        spawn_reserved();
+        if (_freeHead == _null) {
+            if (_slots.size() >= _null)
+                throw std::out_of_range("entity index out of range");
+            _reserve(_slots.size() + 1);
+            _slots.push_back(entity(static_cast<entity::index_type>(_slots.size()), 0));
+            _prev.push_back(_null);
+            return _slots.back();
+        }
+
+        const entity::index_type index = _freeHead;
+
+        _unlink(index);
+        _slots[index] = entity(index, _slots[index].generation());
+        return _slots[index];
+    }
+
+    entity entity_pool::spawn_at(std::size_t index)
+    {
+        spawn_reserved();
+        _claim(index, index + 1);
+        return _slots[index];
+    }
+
+    entity entity_pool::reserve() noexcept
+    {
+        const std::size_t index = _slots.size() + _reserved.count.fetch_add(1, std::memory_order_relaxed);
+
+        return entity(static_cast<entity::index_type>(index), 0);
+    }
+
+    void entity_pool::spawn_reserved()
+    {
+        const std::size_t count = _reserved.count.exchange(0, std::memory_order_relaxed);
+
+        _claim(_slots.size(), _slots.size() + count);
+    }
+
+    bool entity_pool::kill(entity const &e) noexcept
+    {
+        if (!valid(e))
+            return false;
+        _link(e.index(), e.generation() + 1);
+        return true;
+    }
+
+    bool entity_pool::valid(entity const &e) const noexcept
+    {
+        return e.index() < _slots.size() && _slots[e.index()] == e;
+    }
+
+    void entity_pool::check(entity const &e) const
+    {
+        if (!valid(e))
+            throw exceptions::invalid_entity_exception(e);
+    }
+
+    entity entity_pool::at(std::size_t index) const noexcept
+    {
+        return _slots[index];
+    }
+
+    std::size_t entity_pool::size() const noexcept
+    {
+        return _slots.size();
+    }
+
+    void entity_pool::save(std::ostream &out) const
+    {
+        const std::uint64_t slots = _slots.size();
+        const std::uint64_t freeCount = _freeCount;
+
+        snapshot::write_block(out, &slots, 1);
+        snapshot::write_block(out, _slots.data(), _slots.size());
+        snapshot::write_block(out, _prev.data(), _prev.size());
+        snapshot::write_block(out, &_freeHead, 1);
+        snapshot::write_block(out, &freeCount, 1);
+    }
+
+    void entity_pool::load(std::istream &in)
+    {
+        std::uint64_t slots = 0;
+        std::uint64_t freeCount = 0;
+        entity_pool loaded;
+
+        snapshot::read_block(in, &slots, 1);
+        if (slots > _null)
+            throw exceptions::snapshot_exception("corrupted entity pool");
+        snapshot::read_chunks(in, loaded._slots, slots, entity(_null, 0));
+        snapshot::read_chunks(in, loaded._prev, slots, _null);
+        snapshot::read_block(in, &loaded._freeHead, 1);
+        snapshot::read_block(in, &freeCount, 1);
+        if (!loaded._check_free_list(freeCount))
+            throw exceptions::snapshot_exception("corrupted entity pool");
+        loaded._freeCount = freeCount;
+        *this = std::move(loaded);
+    }
+
+    /**
+     * The list is walked once from its head: it must hold exactly the free slots, each linked back to the previous
+     * one. The walk stops after count slots, so a cycle is caught as a list longer than count.
+     */
+    bool entity_pool::_check_free_list(std::size_t count) const noexcept
+    {
+        std::size_t length = 0;
+        std::size_t alive = 0;
+        entity::index_type prev = _null;
+
+        for (entity::index_type index = _freeHead; index != _null; index = _slots[index].index()) {
+            if (index >= _slots.size() || _slots[index].index() == index || _prev[index] != prev || length == count)
+                return false;
+            prev = index;
+            length++;
+        }
+        for (std::size_t i = 0; i < _slots.size(); ++i)
+            alive += _slots[i].index() == i;
+        return length == count && alive + count == _slots.size();
+    }
+
+    void entity_pool::_link(entity::index_type index, entity::generation_type generation) noexcept
+    {
+        _slots[index] = entity(_freeHead, generation);
+        _prev[index] = _null;
+        if (_freeHead != _null)
+            _prev[_freeHead] = index;
+        _freeHead = index;
+        _freeCount++;
+    }
+
+    void entity_pool::_unlink(entity::index_type index) noexcept
+    {
+        const entity::index_type next = _slots[index].index();
+        const entity::index_type prev = _prev[index];
+
+        if (prev == _null)
+            _freeHead = next;
+        else
+            _slots[prev] = entity(next, _slots[prev].generation());
+        if (next != _null)
+            _prev[next] = prev;
+        _freeCount--;
+    }
+
+    /**
+     * Slots added to reach the requested size are linked into the free list, the last one ends up at its head.
+     */
+    void entity_pool::_grow(std::size_t size)
+    {
+        if (size <= _slots.size())
+            return;
+        if (size > _null)
+            throw std::out_of_range("entity index out of range");
+
+        const std::size_t first = _slots.size();
+
+        _reserve(size);
+        _slots.resize(size, entity(_null, 0));
+        _prev.resize(size, _null);
+        for (std::size_t i = first; i < size; ++i)
+            _link(static_cast<entity::index_type>(i), 0);
+    }
+
+    /**
+     * Capacity grows geometrically so growing the pool one slot at a time stays amortized constant.
+     */
+    void entity_pool::_reserve(std::size_t size)
+    {
+        if (size <= _slots.capacity())
+            return;
+        _slots.reserve(std::max(size, _slots.capacity() * 2));
+        _prev.reserve(_slots.capacity());
+    }
+
+    void entity_pool::_claim(std::size_t first, std::size_t last)
+    {
+        if (first >= last)
+            return;
+        if (last > _null)
+            throw std::out_of_range("entity index out of range");
+        for (std::size_t i = first; i < (std::min)(last, _slots.size()); ++i)
+            if (_slots[i].index() == i)
+                throw std::runtime_error("entity already spawned");
+        _grow(last);
+        for (std::size_t i = first; i < last; ++i) {
+            const auto index = static_cast<entity::index_type>(i);
+
+            _unlink(index);
+            _slots[index] = entity(index, _slots[index].generation());
+        }
+    }
+}
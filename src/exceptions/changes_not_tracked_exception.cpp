@@ -0,0 +1,14 @@
+#include "exceptions/changes_not_tracked_exception.hpp"
+
+namespace ecs::exceptions
+{
+    changes_not_tracked_exception::changes_not_tracked_exception(std::type_info const &component) :
+        _errorMessage(std::string("Component ") + component.name() + " is not stored in a sparse_array, its changes "
+            "can't be tracked")
+    {}
+
+    const char *changes_not_tracked_exception::what() const noexcept
+    {
+        return _errorMessage.c_str();
+    }
+}
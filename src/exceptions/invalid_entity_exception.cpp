@@ -0,0 +1,14 @@
+#include "exceptions/invalid_entity_exception.hpp"
+
+namespace ecs::exceptions
+{
+    invalid_entity_exception::invalid_entity_exception(entity const &e) :
+        _errorMessage("Entity " + std::to_string(e.index()) + " of generation " + std::to_string(e.generation()) +
+            " is not alive")
+    {}
+
+    const char *invalid_entity_exception::what() const noexcept
+    {
+        return _errorMessage.c_str();
+    }
+}
@@ -0,0 +1,13 @@
+#include "exceptions/snapshot_exception.hpp"
+
+namespace ecs::exceptions
+{
+    snapshot_exception::snapshot_exception(std::string const &reason) :
+        _errorMessage("Snapshot error: " + reason)
+    {}
+
+    const char *snapshot_exception::what() const noexcept
+    {
+        return _errorMessage.c_str();
+    }
+}
@@ -1,49 +1,414 @@
+#include <atomic>
+#include <exception>
+
 #include "registry.hpp"
+#include "snapshot.hpp"
 
 namespace ecs
 {
-    registry::registry() noexcept :
+    registry::registry() :
+        registry(std::pmr::get_default_resource())
+    {}
+
+    registry::registry(std::pmr::memory_resource *resource) :
         _components{},
+        _resource(resource),
+        _transients{},
+        _groups{},
+        _tick(1),
         _systems{},
-        _spawnedEntities(0)
+        _dependents{},
+        _dependencies{},
+        _scheduled(false),
+        _workers{},
+        _commands(1),
+        _entities{}
     {}
 
-    entity registry::spawn_entity() noexcept
+    registry::registry(registry const &other) :
+        _components{},
+        _resource(other._resource),
+        _transients(other._transients),
+        _groups{},
+        _tick(other._tick),
+        _systems(other._systems),
+        _dependents(other._dependents),
+        _dependencies(other._dependencies),
+        _scheduled(other._scheduled),
+        _workers(other._workers),
+        _commands(other._commands.size()),
+        _entities(other._entities)
+    {
+        _components.reserve(other._components.size());
+        for (auto const &pool : other._components)
+            _components.emplace_back(pool ? pool->clone(_resource) : nullptr);
+        _groups.reserve(other._groups.size());
+        for (auto const &group : other._groups)
+            _groups.push_back(group->clone(_components));
+    }
+
+    registry &registry::operator=(registry const &other)
+    {
+        if (this != &other)
+            *this = registry(other);
+        return *this;
+    }
+
+    void registry::copy_from(registry const &other)
     {
-        const std::size_t num = _freedEntities.empty() ? _spawnedEntities++ : _freedEntities.back();
+        if (this == &other)
+            return;
+
+        bool kept = true;
 
-        if (!_freedEntities.empty())
-            _freedEntities.pop_back();
-        return entity(num);
+        for (std::size_t i = other._components.size(); i < _components.size(); ++i)
+            kept = kept && !_components[i];
+        _components.resize(other._components.size());
+        for (std::size_t i = 0; i < other._components.size(); ++i) {
+            auto const &pool = other._components[i];
+
+            if (pool && _components[i]) {
+                _components[i]->copy_from(*pool);
+            } else if (pool || _components[i]) {
+                _components[i] = pool ? pool->clone(_resource) : nullptr;
+                kept = false;
+            }
+        }
+        kept = kept && _groups.size() == other._groups.size();
+        for (std::size_t i = 0; kept && i < _groups.size(); ++i)
+            kept = _groups[i]->type() == other._groups[i]->type();
+        if (kept) {
+            for (std::size_t i = 0; i < _groups.size(); ++i)
+                _groups[i]->copy_from(*other._groups[i]);
+        } else {
+            _groups.clear();
+            for (auto const &group : other._groups)
+                _groups.push_back(group->clone(_components));
+        }
+        _transients = other._transients;
+        _tick = other._tick;
+        _entities = other._entities;
+        for (auto &buffer : _commands)
+            buffer.clear();
+    }
+
+    entity registry::spawn_entity() noexcept
+    {
+        return _entities.spawn();
     }
 
     entity registry::entity_from_index(std::size_t index)
     {
-        if (index < _spawnedEntities) {
-            auto it = std::find(_freedEntities.begin(), _freedEntities.end(), index);
+        return _entities.spawn_at(index);
+    }
 
-            if (it == _freedEntities.end())
-                throw std::runtime_error("entity already spawned");
-            else
-                _freedEntities.erase(it);
-        } else
-            for (std::size_t i = _spawnedEntities; i < index; ++i)
-                _freedEntities.emplace_back(i);
-        _spawnedEntities = index;
-        return entity(index);
+    entity registry::reserve_entity() noexcept
+    {
+        return _entities.reserve();
     }
 
     void registry::kill_entity(entity const &e) noexcept
     {
-        _freedEntities.emplace_back(e);
+        if (_entities.kill(e))
+            _erase_entities(&e, 1);
+    }
 
-        for (auto &[key, value] : _components)
-            value.second(*this, e);
+    bool registry::valid(entity const &e) const noexcept
+    {
+        return _entities.valid(e);
     }
 
     void registry::run_systems(double deltaTime)
     {
-        for (auto const &system : _systems)
-            system(*this, deltaTime);
+        if (_workers && _systems.size() > 1)
+            _run_concurrently(deltaTime);
+        else
+            for (auto const &system : _systems)
+                system.run(*this, deltaTime);
+        for (auto const id : _transients) {
+            _components[id]->clear();
+            for (auto &group : _groups)
+                if (group->uses(id))
+                    group->clear();
+        }
+        flush_commands();
+        ++_tick;
+        for (auto &pool : _components)
+            if (pool)
+                pool->set_tick(_tick);
+    }
+
+    void registry::set_concurrency(std::size_t threads)
+    {
+        flush_commands();
+        if (threads > 1)
+            _workers = std::make_shared<thread_pool>(threads);
+        else
+            _workers.reset();
+        _commands.resize(_workers ? _workers->size() + 1 : 1);
+    }
+
+    thread_pool *registry::workers() const noexcept
+    {
+        return _workers.get();
+    }
+
+    command_buffer &registry::commands()
+    {
+        return _commands[_workers ? _workers->current_worker() : 0];
+    }
+
+    void registry::flush_commands()
+    {
+        _entities.spawn_reserved();
+        for (auto &buffer : _commands)
+            if (!buffer.empty())
+                buffer.play(*this);
+    }
+
+    void registry::save(std::ostream &out) const
+    {
+        std::uint64_t pools = 0;
+
+        for (auto const &pool : _components)
+            pools += pool != nullptr;
+        snapshot::write_block(out, _snapshot_magic, sizeof(_snapshot_magic));
+        snapshot::write_block(out, &_snapshot_version, 1);
+        _entities.save(out);
+        snapshot::write_block(out, &pools, 1);
+        for (auto const &pool : _components) {
+            if (!pool)
+                continue;
+
+            const std::string name = pool->type().name();
+            const std::uint64_t length = name.size();
+
+            snapshot::write_block(out, &length, 1);
+            snapshot::write_block(out, name.data(), name.size());
+            pool->save(out);
+        }
+    }
+
+    void registry::load(std::istream &in)
+    {
+        char magic[sizeof(_snapshot_magic)] = {};
+        std::uint32_t version = 0;
+        std::uint64_t pools = 0;
+        std::vector<bool> loaded(_components.size(), false);
+
+        try {
+            snapshot::read_block(in, magic, sizeof(magic));
+            snapshot::read_block(in, &version, 1);
+            if (!std::equal(magic, magic + sizeof(magic), _snapshot_magic) || version != _snapshot_version)
+                throw exceptions::snapshot_exception("not a snapshot of this version");
+            _entities.load(in);
+            snapshot::read_block(in, &pools, 1);
+            for (std::uint64_t i = 0; i < pools; ++i) {
+                std::uint64_t length = 0;
+                std::string name;
+
+                snapshot::read_block(in, &length, 1);
+                name.resize(length);
+                snapshot::read_block(in, name.data(), name.size());
+
+                const std::size_t id = _find_pool(name);
+
+                if (id == _components.size())
+                    throw exceptions::snapshot_exception("component " + name + " is not registered");
+                _components[id]->load(in, _entities.size());
+                loaded[id] = true;
+            }
+        } catch (...) {
+            _entities = entity_pool();
+            for (auto &pool : _components)
+                if (pool)
+                    pool->clear();
+            for (auto &group : _groups)
+                group->clear();
+            throw;
+        }
+        for (std::size_t id = 0; id < _components.size(); ++id)
+            if (_components[id] && !loaded[id])
+                _components[id]->clear();
+        _rebuild_groups();
+    }
+
+    registry::tick_type registry::tick() const noexcept
+    {
+        return _tick;
+    }
+
+    std::vector<component_changes> registry::diff(tick_type since) const
+    {
+        std::vector<component_changes> changes;
+
+        for (auto const &pool : _components) {
+            if (!pool || !pool->tracks_changes())
+                continue;
+
+            component_changes pending{ std::type_index(pool->type()), {}, {}, {} };
+
+            pool->collect_changes(since, pending);
+            if (!pending.added.empty() || !pending.changed.empty() || !pending.removed.empty())
+                changes.push_back(std::move(pending));
+        }
+        return changes;
+    }
+
+    void registry::discard_changes(tick_type until)
+    {
+        for (auto &pool : _components)
+            if (pool)
+                pool->discard_changes(until);
+    }
+
+    void registry::save_changes(std::ostream &out, tick_type since) const
+    {
+        std::uint64_t pools = 0;
+
+        for (auto const &pool : _components)
+            pools += pool && pool->tracks_changes();
+        snapshot::write_block(out, _delta_magic, sizeof(_delta_magic));
+        snapshot::write_block(out, &_snapshot_version, 1);
+        snapshot::write_block(out, &pools, 1);
+        for (auto const &pool : _components) {
+            if (!pool || !pool->tracks_changes())
+                continue;
+
+            const std::string name = pool->type().name();
+            const std::uint64_t length = name.size();
+
+            snapshot::write_block(out, &length, 1);
+            snapshot::write_block(out, name.data(), name.size());
+            pool->save_changes(out, since);
+        }
+    }
+
+    void registry::load_changes(std::istream &in)
+    {
+        char magic[sizeof(_delta_magic)] = {};
+        std::uint32_t version = 0;
+        std::uint64_t pools = 0;
+
+        snapshot::read_block(in, magic, sizeof(magic));
+        snapshot::read_block(in, &version, 1);
+        if (!std::equal(magic, magic + sizeof(magic), _delta_magic) || version != _snapshot_version)
+            throw exceptions::snapshot_exception("not a delta snapshot of this version");
+        snapshot::read_block(in, &pools, 1);
+        try {
+            for (std::uint64_t i = 0; i < pools; ++i) {
+                std::uint64_t length = 0;
+                std::string name;
+
+                snapshot::read_block(in, &length, 1);
+                name.resize(length);
+                snapshot::read_block(in, name.data(), name.size());
+
+                const std::size_t id = _find_pool(name);
+
+                if (id == _components.size())
+                    throw exceptions::snapshot_exception("component " + name + " is not registered");
+                _components[id]->load_changes(in, _entities.size());
+            }
+        } catch (...) {
+            _rebuild_groups();
+            throw;
+        }
+        _rebuild_groups();
+    }
+
+    void registry::_erase_entities(entity const *entities, std::size_t count) noexcept
+    {
+        if (count == 0)
+            return;
+        for (auto &pool : _components) {
+            if (!pool)
+                continue;
+            if (!pool->on_destroy().empty())
+                for (std::size_t i = 0; i < count; ++i)
+                    if (pool->contains(entities[i]))
+                        pool->on_destroy().publish(*this, entities[i]);
+            pool->remove(entities, count);
+        }
+    }
+
+    void registry::_rebuild_groups()
+    {
+        for (auto &group : _groups)
+            group->rebuild(_entities);
+    }
+
+    std::size_t registry::_find_pool(std::string const &name) const noexcept
+    {
+        for (std::size_t id = 0; id < _components.size(); ++id)
+            if (_components[id] && name == _components[id]->type().name())
+                return id;
+        return _components.size();
+    }
+
+    void registry::_schedule()
+    {
+        const auto conflict = [](system const &lhs, system const &rhs) {
+            if (lhs.access.empty() || rhs.access.empty())
+                return true;
+            for (auto const &[lhsId, lhsMutable] : lhs.access)
+                for (auto const &[rhsId, rhsMutable] : rhs.access)
+                    if (lhsId == rhsId && (lhsMutable || rhsMutable))
+                        return true;
+            return false;
+        };
+
+        _dependents.assign(_systems.size(), {});
+        _dependencies.assign(_systems.size(), 0);
+        for (std::size_t i = 0; i < _systems.size(); ++i)
+            for (std::size_t j = i + 1; j < _systems.size(); ++j)
+                if (conflict(_systems[i], _systems[j])) {
+                    _dependents[i].push_back(j);
+                    _dependencies[j]++;
+                }
+        _scheduled = true;
+    }
+
+    void registry::_run_concurrently(double deltaTime)
+    {
+        if (!_scheduled)
+            _schedule();
+
+        std::vector<std::atomic<std::size_t>> pending(_systems.size());
+        std::size_t remaining = _systems.size();
+        std::exception_ptr error{};
+        std::mutex mutex{};
+        std::condition_variable done{};
+        std::function<void (std::size_t)> run;
+
+        for (std::size_t i = 0; i < _systems.size(); ++i)
+            pending[i].store(_dependencies[i], std::memory_order_relaxed);
+        run = [&](std::size_t i) {
+            try {
+                _systems[i].run(*this, deltaTime);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (!error)
+                    error = std::current_exception();
+            }
+            for (auto dependent : _dependents[i])
+                if (pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    _workers->submit([&run, dependent] { run(dependent); });
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (--remaining == 0)
+                done.notify_all();
+        };
+        for (std::size_t i = 0; i < _systems.size(); ++i)
+            if (_dependencies[i] == 0)
+                _workers->submit([&run, i] { run(i); });
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        done.wait(lock, [&remaining] { return remaining == 0; });
+        if (error)
+            std::rethrow_exception(error);
     }
-}
\ No newline at end of file
+}
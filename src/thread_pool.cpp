@@ -0,0 +1,181 @@
+#include <algorithm>
+
+#include "thread_pool.hpp"
+
+namespace
+{
+    thread_local ecs::thread_pool const *currentPool = nullptr;
+
+    thread_local std::size_t currentWorker = 0;
+}
+
+namespace ecs
+{
+    thread_pool::thread_pool(std::size_t workers) :
+        _queues{},
+        _workers{},
+        _next(0),
+        _pending(0),
+        _mutex{},
+        _condition{},
+        _stopping(false)
+    {
+        if (workers == 0)
+            workers = 1;
+        _queues.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i)
+            _queues.emplace_back(std::make_unique<worker_queue>());
+        _workers.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i)
+            _workers.emplace_back(&thread_pool::_work, this, i);
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _stopping = true;
+        }
+        _condition.notify_all();
+        for (auto &worker : _workers)
+            worker.join();
+    }
+
+    /**
+     * The task is counted before it is published: a worker popping it decrements a count that already includes it, so
+     * the count never wraps around.
+     */
+    void thread_pool::submit(task t)
+    {
+        const std::size_t index = currentPool == this ?
+            currentWorker :
+            _next.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _pending++;
+        }
+        try {
+            std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+
+            _queues[index]->tasks.emplace_back(std::move(t));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _pending--;
+            throw;
+        }
+        _condition.notify_one();
+    }
+
+    std::size_t thread_pool::chunk_size(std::size_t range, std::size_t footprint) const noexcept
+    {
+        static constexpr std::size_t cacheLine = 64;
+        constexpr std::size_t chunkBytes = 16 * 1024;
+        constexpr std::size_t chunksPerThread = 4;
+        const auto roundUp = [](std::size_t n) {
+            return std::max(cacheLine, (n + cacheLine - 1) / cacheLine * cacheLine);
+        };
+        const std::size_t balanced = roundUp(range / ((_workers.size() + 1) * chunksPerThread));
+
+        return std::min(roundUp(chunkBytes / std::max<std::size_t>(footprint, 1)), balanced);
+    }
+
+    std::size_t thread_pool::size() const noexcept
+    {
+        return _workers.size();
+    }
+
+    std::size_t thread_pool::current_worker() const noexcept
+    {
+        return currentPool == this ? currentWorker : _workers.size();
+    }
+
+    void thread_pool::_work(std::size_t index)
+    {
+        currentPool = this;
+        currentWorker = index;
+        while (true) {
+            task t;
+
+            if (_pop(index, t)) {
+                t();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _condition.wait(lock, [this] { return _stopping || _pending > 0; });
+            if (_stopping && _pending == 0)
+                return;
+        }
+    }
+
+    bool thread_pool::_pop(std::size_t index, task &t)
+    {
+        for (std::size_t i = 0; i < _queues.size(); ++i) {
+            auto &queue = *_queues[(index + i) % _queues.size()];
+            std::unique_lock<std::mutex> lock(queue.mutex);
+
+            if (queue.tasks.empty())
+                continue;
+            if (i == 0) {
+                t = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                t = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            lock.unlock();
+
+            std::lock_guard<std::mutex> pendingLock(_mutex);
+
+            _pending--;
+            return true;
+        }
+        return false;
+    }
+
+    thread_pool::parallel_state::parallel_state(
+        std::size_t first,
+        std::size_t last,
+        std::size_t grain,
+        std::size_t chunks) noexcept :
+        first(first),
+        last(last),
+        grain(grain),
+        chunks(chunks)
+    {}
+
+    void thread_pool::parallel_state::run() noexcept
+    {
+        for (std::size_t chunk = next++; chunk < chunks; chunk = next++) {
+            const std::size_t lo = first + chunk * grain;
+
+            try {
+                body(lo, std::min(lo + grain, last));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (!error)
+                    error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (++done == chunks)
+                finished.notify_all();
+        }
+    }
+
+    void thread_pool::parallel_state::wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        finished.wait(lock, [this] { return done == chunks; });
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
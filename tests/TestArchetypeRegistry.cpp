@@ -0,0 +1,141 @@
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <catch2/catch_test_macros.hpp>
+#include <archetype_registry.hpp>
+
+struct health {
+    int points;
+};
+
+struct armor {
+    int value;
+};
+
+TEST_CASE("Archetype registry components", "[archetype_registry]")
+{
+    ecs::archetype_registry registry;
+    auto entity = registry.spawn_entity();
+    auto other = registry.spawn_entity();
+
+    registry.add_component<health>(entity, {10});
+    registry.emplace_component<armor>(entity, armor{3});
+    registry.add_component(other, std::string("name"));
+    registry.add_component<health>(other, {20});
+    REQUIRE(registry.get_component<health>(entity).points == 10);
+    REQUIRE(registry.get_component<armor>(entity).value == 3);
+    REQUIRE(registry.get_component<std::string>(other) == "name");
+    registry.remove_component<health>(entity);
+    REQUIRE_FALSE(registry.has_component<health>(entity));
+    REQUIRE(registry.get_component<armor>(entity).value == 3);
+    REQUIRE(registry.get_component<health>(other).points == 20);
+    REQUIRE_THROWS_AS(registry.get_component<health>(entity), std::out_of_range);
+}
+
+TEST_CASE("Archetype registry kill entity", "[archetype_registry]")
+{
+    ecs::archetype_registry registry;
+    auto first = registry.spawn_entity();
+    auto second = registry.spawn_entity();
+
+    registry.add_component<health>(first, {1});
+    registry.add_component<health>(second, {2});
+    registry.kill_entity(first);
+    REQUIRE_FALSE(registry.valid(first));
+    REQUIRE_FALSE(registry.has_component<health>(first));
+    REQUIRE(registry.get_component<health>(second).points == 2);
+    REQUIRE_THROWS_AS(registry.add_component<health>(first, {3}), std::out_of_range);
+    REQUIRE(registry.get_view<health>().size() == 1);
+}
+
+TEST_CASE("Archetype registry views", "[archetype_registry]")
+{
+    ecs::archetype_registry registry;
+    int total = 0;
+
+    for (int i = 0; i < 100; ++i) {
+        auto entity = registry.spawn_entity();
+
+        registry.add_component<health>(entity, {i});
+        if (i % 2 == 0)
+            registry.add_component<armor>(entity, {i});
+        if (i % 5 == 0)
+            registry.add_component(entity, std::string("tag"));
+    }
+    REQUIRE(registry.get_view<health, armor>().size() == 50);
+    registry.get_view<health const, armor>().each([&total](health const &h, armor &a) {
+        REQUIRE(h.points == a.value);
+        total += h.points;
+    });
+    REQUIRE(total == 2450);
+}
+
+TEST_CASE("Archetype registry systems", "[archetype_registry]")
+{
+    ecs::archetype_registry registry;
+    auto entity = registry.spawn_entity();
+
+    registry.add_component<health>(entity, {1});
+    registry.add_system<health>([](ecs::archetype_registry &, double, auto view) {
+        view.each([](health &h) {
+            h.points *= 2;
+        });
+    });
+    registry.run_systems(0);
+    registry.run_systems(0);
+
+    ecs::archetype_registry copy(registry);
+
+    registry.get_component<health>(entity).points = 0;
+    REQUIRE(copy.get_component<health>(entity).points == 4);
+}
+
+struct counter {
+    int value;
+};
+
+struct total {
+    int value;
+};
+
+TEST_CASE("Archetype registry systems run in order", "[archetype_registry]")
+{
+    ecs::archetype_registry registry;
+    std::vector<ecs::entity> entities;
+
+    for (int i = 0; i < 100; ++i) {
+        entities.push_back(registry.spawn_entity());
+        registry.add_component<counter>(entities.back(), {i});
+        registry.add_component<total>(entities.back(), {0});
+    }
+    for (int step = 0; step < 10; ++step) {
+        registry.add_system<counter>([](ecs::archetype_registry &, double, auto view) {
+            view.each([](counter &c) {
+                c.value *= 2;
+            });
+        });
+        registry.add_system<counter const, total>([](ecs::archetype_registry &, double, auto view) {
+            view.each([](counter const &c, total &t) {
+                t.value += c.value;
+            });
+        });
+    }
+    registry.run_systems(0);
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(registry.get_component<total>(entities[i]).value == i * 2046);
+}
+
+TEST_CASE("Archetype registry systems exception is propagated", "[archetype_registry]")
+{
+    ecs::archetype_registry registry;
+    int runs = 0;
+
+    registry.add_system<counter const>([](ecs::archetype_registry &, double, auto) {
+        throw std::runtime_error("system failure");
+    });
+    registry.add_system<counter const>([&runs](ecs::archetype_registry &, double, auto) {
+        ++runs;
+    });
+    REQUIRE_THROWS_AS(registry.run_systems(0), std::runtime_error);
+    REQUIRE(runs == 0);
+}
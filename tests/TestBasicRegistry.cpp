@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+#include <basic_registry.hpp>
+#include <zipper.hpp>
+
+struct position {
+    float x;
+    float y;
+};
+
+struct speed {
+    float x;
+    float y;
+};
+
+using world = ecs::basic_registry<position, speed>;
+
+TEST_CASE("Static registry components", "[basic_registry]")
+{
+    world registry;
+    auto entity = registry.spawn_entity();
+
+    registry.add_component<position>(entity, {1, 2});
+    registry.emplace_component<speed>(entity, speed{3, 4});
+    REQUIRE(registry.get_component<position>()[entity]->x == 1);
+    REQUIRE(registry.get_component<speed>()[entity]->y == 4);
+    registry.remove_component<speed>(entity);
+    REQUIRE_FALSE(registry.get_component<speed>().contains(entity));
+}
+
+TEST_CASE("Static registry kill entity", "[basic_registry]")
+{
+    world registry;
+    auto entity = registry.spawn_entity();
+
+    registry.add_component<position>(entity, {1, 2});
+    registry.kill_entity(entity);
+    REQUIRE_FALSE(registry.valid(entity));
+    REQUIRE_FALSE(registry.get_component<position>().contains(entity));
+}
+
+TEST_CASE("Static registry stale entity handle", "[basic_registry]")
+{
+    world registry;
+    auto entity = registry.spawn_entity();
+
+    registry.kill_entity(entity);
+    REQUIRE_THROWS_AS(registry.add_component<position>(entity, {1, 2}), ecs::exceptions::invalid_entity_exception);
+    REQUIRE_THROWS_AS(registry.emplace_component<speed>(entity, speed{3, 4}),
+        ecs::exceptions::invalid_entity_exception);
+
+    auto respawned = registry.spawn_entity();
+
+    REQUIRE(respawned.index() == entity.index());
+    REQUIRE_FALSE(registry.get_component<position>().contains(respawned));
+    registry.add_component<position>(respawned, {5, 6});
+    registry.remove_component<position>(entity);
+    REQUIRE(registry.get_component<position>()[respawned]->x == 5);
+}
+
+TEST_CASE("Static registry systems", "[basic_registry]")
+{
+    world registry;
+    auto movement = [](world &, double dt, auto &positions, auto &speeds) {
+        for (auto &&[p, s] : ecs::containers::zipper(positions, speeds)) {
+            p.x += s.x * static_cast<float>(dt);
+            p.y += s.y * static_cast<float>(dt);
+        }
+    };
+
+    for (int i = 0; i < 10; ++i) {
+        auto entity = registry.spawn_entity();
+
+        registry.add_component<position>(entity, {0, 0});
+        if (i & 1)
+            registry.add_component<speed>(entity, {1, 1});
+    }
+    registry.add_system<position, speed>(movement);
+    registry.run_systems(1);
+    registry.run_system<position, speed>(1, movement);
+    REQUIRE(registry.get_component<position>()[1]->x == 2);
+    REQUIRE(registry.get_component<position>()[2]->x == 0);
+}
+
+TEST_CASE("Static registry systems reading const components", "[basic_registry]")
+{
+    world registry;
+    float total = 0;
+    auto sum = [&total](world &, double, ecs::containers::sparse_array<position> const &positions,
+        ecs::containers::sparse_array<speed> &speeds) {
+        for (std::size_t i = 0; i < speeds.size(); ++i) {
+            if (!speeds.contains(i) || !positions.contains(i))
+                continue;
+            total += positions[i]->x;
+            speeds[i]->x = positions[i]->x;
+        }
+    };
+
+    for (int i = 0; i < 4; ++i) {
+        auto entity = registry.spawn_entity();
+
+        registry.add_component<position>(entity, {static_cast<float>(i), 0});
+        if (i == 3)
+            registry.add_component<speed>(entity, {0, 0});
+    }
+    registry.add_system<position const, speed>(sum);
+    registry.run_systems(0);
+    registry.run_system<position const, speed>(0, sum);
+    REQUIRE(total == 6);
+    REQUIRE(registry.get_component<speed>()[3]->x == 3);
+}
@@ -0,0 +1,106 @@
+#include <vector>
+#include <utility>
+#include <catch2/catch_test_macros.hpp>
+#include <registry.hpp>
+#include <batch.hpp>
+
+struct charge {
+    int value;
+};
+
+struct spin {
+    float angle;
+    float rate;
+};
+
+template<>
+struct ecs::soa_fields<spin>
+{
+    static constexpr auto members = std::make_tuple(&spin::angle, &spin::rate);
+};
+
+template<>
+struct ecs::component_storage<spin>
+{
+    using type = ecs::containers::soa_array<spin>;
+};
+
+using run = std::pair<std::size_t, std::size_t>;
+
+TEST_CASE("each_batch walks the runs of positions owned by every container", "[batch]")
+{
+    ecs::containers::sparse_array<charge> charges;
+    ecs::containers::sparse_array<long> other;
+    std::vector<run> runs;
+
+    for (std::size_t i = 0; i < 300; ++i) {
+        if (i < 10 || (i >= 60 && i < 200) || i == 250)
+            charges.insert_at(i, charge{ static_cast<int>(i) });
+        if (i != 5)
+            other.insert_at(i, 1);
+    }
+    ecs::containers::each_batch([&runs](std::size_t first, std::size_t count, auto c, auto o) {
+        runs.emplace_back(first, count);
+        for (std::size_t i = 0; i < count; ++i) {
+            REQUIRE(c[i].value == static_cast<int>(first + i));
+            c[i].value += static_cast<int>(o[i]);
+        }
+    }, charges, std::as_const(other));
+    REQUIRE(runs == std::vector<run>{ { 0, 5 }, { 6, 4 }, { 60, 140 }, { 250, 1 } });
+    REQUIRE(charges.get(70).value == 71);
+    REQUIRE(charges.get(5).value == 5);
+}
+
+TEST_CASE("each_batch cuts the runs at the page boundaries", "[batch]")
+{
+    ecs::containers::sparse_array<charge> charges;
+    ecs::containers::soa_array<spin> spins;
+    const std::size_t n = ecs::containers::soa_array<spin>::page_size * 2 + 10;
+    std::vector<run> runs;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        charges.insert_at(i, charge{ 1 });
+        spins.insert_at(i, spin{ 0, 2 });
+    }
+    ecs::containers::each_batch([&runs](std::size_t first, std::size_t count, auto c, auto s) {
+        auto angle = s.template field<&spin::angle>();
+        auto const rate = s.template get<1>();
+
+        runs.emplace_back(first, count);
+        REQUIRE(angle.size() == count);
+        for (std::size_t i = 0; i < count; ++i)
+            angle[i] += rate[i] * static_cast<float>(c[i].value);
+    }, std::as_const(charges), spins);
+
+    const std::size_t page = ecs::containers::sparse_array<charge>::page_size;
+
+    REQUIRE(runs.front() == run{ 0, page });
+    REQUIRE(runs.back().first + runs.back().second == n);
+    for (auto const &r : runs)
+        REQUIRE(r.first / page == (r.first + r.second - 1) / page);
+    REQUIRE(spins.get(n - 1).get<0>() == 2);
+}
+
+TEST_CASE("Registry runs batches over its components", "[batch]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+    std::size_t visited = 0;
+
+    registry.register_component<charge>();
+    registry.register_component<spin>();
+    registry.spawn_entities(100, std::back_inserter(entities));
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        registry.add_component<spin>(entities[i], spin{ 0, 1 });
+        if (i % 3)
+            registry.add_component<charge>(entities[i], charge{ 2 });
+    }
+    registry.each_batch<spin, charge const>([&visited](std::size_t, std::size_t count, auto s, auto c) {
+        for (std::size_t i = 0; i < count; ++i)
+            s[i] = spin{ static_cast<float>(c[i].value), s[i].template get<1>() };
+        visited += count;
+    });
+    REQUIRE(visited == 66);
+    REQUIRE(registry.get_component<spin>().get(entities[1].index()).get<0>() == 2);
+    REQUIRE(registry.get_component<spin>().get(entities[3].index()).get<0>() == 0);
+}
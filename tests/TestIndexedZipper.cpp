@@ -1,3 +1,4 @@
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <registry.hpp>
 #include <indexed_zipper.hpp>
@@ -58,3 +59,20 @@ TEST_CASE("indexed_zipper Iterate over multiple sparse_array (entity matching)",
     else
         SUCCEED();
 }
+
+TEST_CASE("indexed_zipper parallel iteration", "[indexed_zipper]")
+{
+    ecs::containers::sparse_array<std::size_t> arr;
+    ecs::thread_pool pool(4);
+    std::atomic<std::size_t> sum{0};
+
+    for (std::size_t i = 0; i < 100000; ++i)
+        if (i & 1)
+            arr.emplace_at(i, 0);
+    ecs::containers::indexed_zipper(arr).par_each(pool, [&sum](std::size_t entity, std::size_t &component) {
+        component = entity;
+        sum += entity;
+    });
+    REQUIRE(sum == 2500000000);
+    REQUIRE(*arr[99] == 99);
+}
@@ -0,0 +1,153 @@
+#include <vector>
+#include <iterator>
+#include <catch2/catch_test_macros.hpp>
+#include <registry.hpp>
+#include <zipper.hpp>
+#include <indexed_zipper.hpp>
+
+struct spark {
+    int power;
+};
+
+struct fuel {
+    int amount;
+};
+
+struct ember {
+    int heat;
+
+    explicit ember(int heat) : heat(heat) {};
+};
+
+TEST_CASE("Commands recorded by a system are applied after the systems", "[Commands]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+
+    registry.register_component<spark>();
+    registry.register_component<fuel>();
+    registry.spawn_entities(100, std::back_inserter(entities));
+    for (std::size_t i = 0; i < entities.size(); ++i)
+        registry.add_component<spark>(entities[i], spark{ static_cast<int>(i) });
+    registry.add_system<spark, fuel>([&entities](ecs::registry &r, double,
+        ecs::containers::sparse_array<spark> &sparks, ecs::containers::sparse_array<fuel> &fuels) {
+        for (auto &&[index, s] : ecs::containers::indexed_zipper(sparks)) {
+            auto const &e = entities[index];
+
+            r.commands().add(e, fuel{ s.power * 2 });
+            if (index % 2)
+                r.commands().remove<spark>(e);
+            if (index % 5 == 0)
+                r.commands().kill(e);
+        }
+        REQUIRE(sparks.count() == 100);
+        REQUIRE(fuels.count() == 0);
+    });
+    registry.run_systems(0);
+    REQUIRE(registry.commands().empty());
+
+    auto const &sparks = registry.get_component<spark>();
+    auto const &fuels = registry.get_component<fuel>();
+
+    REQUIRE(fuels.count() == 80);
+    REQUIRE(sparks.count() == 40);
+    REQUIRE(fuels[entities[3]]->amount == 6);
+    REQUIRE_FALSE(sparks[entities[3]]);
+    REQUIRE(sparks[entities[2]]->power == 2);
+    REQUIRE_FALSE(registry.valid(entities[10]));
+    REQUIRE_FALSE(fuels[entities[10]]);
+}
+
+TEST_CASE("Reserved entities are spawned by flush_commands", "[Commands]")
+{
+    ecs::registry registry;
+    auto first = registry.spawn_entity();
+
+    registry.register_component<spark>();
+    registry.register_component<ember>();
+
+    auto reserved = registry.reserve_entity();
+    auto other = registry.reserve_entity();
+
+    REQUIRE(reserved.index() == first.index() + 1);
+    REQUIRE(other.index() == first.index() + 2);
+    REQUIRE_FALSE(registry.valid(reserved));
+    registry.commands().add(reserved, spark{ 7 });
+    registry.commands().emplace<ember>(reserved, 3);
+    registry.flush_commands();
+    REQUIRE(registry.valid(reserved));
+    REQUIRE(registry.valid(other));
+    REQUIRE(registry.get_component<spark>()[reserved]->power == 7);
+    REQUIRE(registry.get_component<ember>()[reserved]->heat == 3);
+
+    auto spawned = registry.reserve_entity();
+    auto next = registry.spawn_entity();
+
+    REQUIRE(registry.valid(spawned));
+    REQUIRE(next.index() == spawned.index() + 1);
+}
+
+TEST_CASE("The last command of an entity wins", "[Commands]")
+{
+    ecs::registry registry;
+    auto first = registry.spawn_entity();
+    auto second = registry.spawn_entity();
+    auto dead = registry.spawn_entity();
+    int constructed = 0;
+    int destroyed = 0;
+
+    registry.register_component<spark>();
+    registry.add_component<spark>(second, spark{ 1 });
+    registry.on_construct<spark>().connect([&constructed](ecs::registry &, ecs::entity const &) {
+        constructed++;
+    });
+    registry.on_destroy<spark>().connect([&destroyed](ecs::registry &, ecs::entity const &) {
+        destroyed++;
+    });
+
+    auto &commands = registry.commands();
+
+    commands.add(second, spark{ 2 });
+    commands.add(first, spark{ 1 });
+    commands.remove<spark>(second);
+    commands.add(first, spark{ 3 });
+    commands.add(dead, spark{ 4 });
+    registry.kill_entity(dead);
+    REQUIRE_FALSE(commands.empty());
+    registry.flush_commands();
+    REQUIRE(commands.empty());
+
+    auto const &sparks = registry.get_component<spark>();
+
+    REQUIRE(sparks[first]->power == 3);
+    REQUIRE_FALSE(sparks[second]);
+    REQUIRE_FALSE(sparks[dead]);
+    REQUIRE(constructed == 1);
+    REQUIRE(destroyed == 1);
+}
+
+TEST_CASE("Systems running concurrently record into their own buffers", "[Commands]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+
+    registry.register_component<spark>();
+    registry.register_component<fuel>();
+    registry.spawn_entities(10, std::back_inserter(entities));
+    for (auto const &e : entities)
+        registry.add_component<spark>(e, spark{ 1 });
+    registry.set_concurrency(4);
+    for (int system = 0; system < 8; ++system)
+        registry.add_system<spark const>([](ecs::registry &r, double, ecs::containers::sparse_array<spark> const &) {
+            for (int i = 0; i < 100; ++i)
+                r.commands().add(r.reserve_entity(), fuel{ i });
+        });
+    registry.run_systems(0);
+
+    auto const &fuels = registry.get_component<fuel>();
+
+    REQUIRE(fuels.count() == 800);
+    for (std::size_t i = entities.size(); i < entities.size() + 800; ++i)
+        REQUIRE(fuels.contains(i));
+    REQUIRE(registry.spawn_entity().index() == entities.size() + 800);
+}
@@ -1,5 +1,9 @@
+#include <string>
+#include <vector>
+#include <iterator>
 #include <catch2/catch_test_macros.hpp>
 #include <registry.hpp>
+#include <memory_resource.hpp>
 
 struct velocity {
     int x;
@@ -8,6 +12,53 @@ struct velocity {
     velocity(int x, int y) : x(x), y(y) {};
 };
 
+struct mass {
+    float value;
+
+    explicit mass(float value) : value(value) {};
+};
+
+struct heading {
+    float angle;
+};
+
+template<>
+struct ecs::component_storage<mass>
+{
+    using type = ecs::pmr::sparse_set<mass>;
+};
+
+template<>
+struct ecs::component_storage<heading>
+{
+    using type = ecs::pmr::sparse_array<heading>;
+};
+
+struct counting_resource : std::pmr::memory_resource
+{
+    std::size_t allocated = 0;
+
+    std::size_t allocations = 0;
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        allocated += bytes;
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+    {
+        allocated -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
 TEST_CASE("Register component", "[Components]")
 {
     ecs::registry registry;
@@ -101,3 +152,144 @@ TEST_CASE("Get not existing component", "[Components]")
     registry.register_component<velocity>();
     REQUIRE_THROWS_AS(registry.get_component<int>(), ecs::exceptions::component_not_registered_exception);
 }
+
+TEST_CASE("Component ids are dense and stable", "[Components]")
+{
+    struct first {};
+    struct second {};
+
+    const auto firstId = ecs::component_id::get<first>();
+
+    REQUIRE(ecs::component_id::get<second>() == firstId + 1);
+    REQUIRE(ecs::component_id::get<first>() == firstId);
+    REQUIRE(ecs::component_id::get<first const>() == firstId);
+}
+
+TEST_CASE("Copied registry owns its components", "[Components]")
+{
+    ecs::registry registry;
+    auto entity = registry.spawn_entity();
+
+    registry.register_component<velocity>();
+    registry.emplace_component<velocity>(entity, 1, 2);
+
+    ecs::registry copy(registry);
+
+    copy.get_component<velocity>()[entity]->x = 10;
+    REQUIRE(registry.get_component<velocity>()[entity]->x == 1);
+    REQUIRE(copy.get_component<velocity>()[entity]->x == 10);
+}
+
+TEST_CASE("Register component twice", "[Components]")
+{
+    ecs::registry registry;
+
+    registry.register_component<velocity>();
+    REQUIRE_THROWS_AS(registry.register_component<velocity>(), ecs::exceptions::component_already_registered_exception);
+}
+
+TEST_CASE("Insert a range of components", "[Registry]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+    std::vector<std::string> names{ "a", "b", "c" };
+
+    registry.register_component<std::string>();
+    registry.spawn_entities(3, std::back_inserter(entities));
+    registry.insert_range<std::string>(entities, names);
+    REQUIRE(names[1] == "b");
+    REQUIRE(*registry.get_component<std::string>()[entities[1]] == "b");
+    registry.insert_range<std::string>(entities, std::move(names));
+    REQUIRE(registry.get_component<std::string>().count() == 3);
+}
+
+TEST_CASE("Type erased component pool", "[Registry]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+    ecs::component_pool<ecs::containers::sparse_array<int>> pool;
+    ecs::pool_base &base = pool;
+
+    registry.spawn_entities(4, std::back_inserter(entities));
+    base.reserve(4);
+    pool.storage().emplace_n(entities.begin(), entities.end(), 1);
+    REQUIRE(base.size() == 4);
+    REQUIRE(base.contains(entities[2]));
+    base.remove(entities[2]);
+    REQUIRE_FALSE(base.contains(entities[2]));
+    base.remove(entities.data(), 2);
+    REQUIRE(base.size() == 1);
+
+    auto copy = base.clone(std::pmr::get_default_resource());
+
+    base.clear();
+    REQUIRE(base.size() == 0);
+    REQUIRE(copy->size() == 1);
+    REQUIRE(copy->type() == typeid(int));
+}
+
+TEST_CASE("Components allocated from a memory resource", "[Registry]")
+{
+    counting_resource resource;
+
+    {
+        ecs::registry registry(&resource);
+        auto &masses = registry.register_component<mass>();
+        auto entity = registry.spawn_entity();
+
+        registry.emplace_component<mass>(entity, 2.f);
+        REQUIRE(masses.get_allocator().resource() == &resource);
+        REQUIRE(resource.allocated > 0);
+
+        ecs::registry copy(registry);
+
+        REQUIRE(copy.get_component<mass>().get_allocator().resource() == &resource);
+        REQUIRE(copy.get_component<mass>()[entity].value == 2.f);
+        registry.kill_entity(entity);
+        REQUIRE(copy.get_component<mass>().size() == 1);
+    }
+    REQUIRE(resource.allocated == 0);
+}
+
+TEST_CASE("Restore a copy of a registry in place", "[Registry]")
+{
+    counting_resource resource;
+    ecs::registry registry(&resource);
+    std::vector<ecs::entity> entities;
+
+    registry.register_component<heading>();
+    registry.register_component<mass>();
+    registry.spawn_entities(3000, std::back_inserter(entities));
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        registry.add_component<heading>(entities[i], heading{ static_cast<float>(i) });
+        if (i % 2)
+            registry.emplace_component<mass>(entities[i], 1.f);
+    }
+    REQUIRE(registry.group<heading, mass>().size() == 1500);
+
+    ecs::registry saved(registry);
+
+    for (std::size_t i = 0; i < entities.size(); i += 3)
+        registry.get_component<heading>()[entities[i]]->angle = -1;
+    registry.remove_component<mass>(entities[1]);
+    registry.kill_entity(entities[5]);
+
+    const std::size_t allocations = resource.allocations;
+
+    registry.copy_from(saved);
+    REQUIRE(resource.allocations == allocations);
+    REQUIRE(registry.valid(entities[5]));
+    REQUIRE(registry.get_component<heading>()[entities[3]]->angle == 3);
+    REQUIRE(registry.get_component<mass>().contains(entities[1]));
+    REQUIRE(registry.group<heading, mass>().size() == 1500);
+    REQUIRE(registry.group<heading, mass>().contains(entities[5]));
+
+    ecs::registry other(&resource);
+
+    other.copy_from(saved);
+    REQUIRE(other.get_component<heading>().count() == 3000);
+    REQUIRE(other.get_component<mass>().get_allocator().resource() == &resource);
+    other.kill_entity(entities[7]);
+    REQUIRE_FALSE(other.group<heading, mass>().contains(entities[7]));
+    REQUIRE(saved.group<heading, mass>().contains(entities[7]));
+}
@@ -1,3 +1,5 @@
+#include <vector>
+#include <iterator>
 #include <catch2/catch_test_macros.hpp>
 #include <registry.hpp>
 
@@ -19,3 +21,117 @@ TEST_CASE("entity kill and respawn", "[Entities]")
     entity = registry.spawn_entity();
     REQUIRE(entity == 0);
 }
+
+TEST_CASE("stale entity handle is invalid", "[Entities]")
+{
+    ecs::registry registry;
+    auto entity = registry.spawn_entity();
+
+    REQUIRE(registry.valid(entity));
+    registry.kill_entity(entity);
+    REQUIRE_FALSE(registry.valid(entity));
+
+    auto respawned = registry.spawn_entity();
+
+    REQUIRE(respawned.index() == entity.index());
+    REQUIRE(respawned.generation() == entity.generation() + 1);
+    REQUIRE(respawned != entity);
+    REQUIRE_FALSE(registry.valid(entity));
+    REQUIRE(registry.valid(respawned));
+}
+
+TEST_CASE("killing a stale entity handle does nothing", "[Entities]")
+{
+    ecs::registry registry;
+    auto entity = registry.spawn_entity();
+
+    registry.kill_entity(entity);
+
+    auto respawned = registry.spawn_entity();
+
+    registry.kill_entity(entity);
+    REQUIRE(registry.valid(respawned));
+}
+
+TEST_CASE("writing components through a stale entity handle", "[Entities]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> stale;
+
+    registry.register_component<int>();
+    registry.spawn_entities(2, std::back_inserter(stale));
+    registry.add_component<int>(stale[0], 1);
+    registry.kill_entities(stale);
+    REQUIRE_THROWS_AS(registry.add_component<int>(stale[0], 2), ecs::exceptions::invalid_entity_exception);
+    REQUIRE_THROWS_AS(registry.emplace_component<int>(stale[1], 2), ecs::exceptions::invalid_entity_exception);
+    REQUIRE_THROWS_AS(registry.insert_range<int>(stale, std::vector<int>{ 2, 3 }),
+        ecs::exceptions::invalid_entity_exception);
+    REQUIRE_THROWS_AS(registry.emplace_n<int>(stale, 2), ecs::exceptions::invalid_entity_exception);
+    REQUIRE_THROWS_AS(registry.patch<int>(stale[0], [](int &value) { value = 2; }),
+        ecs::exceptions::invalid_entity_exception);
+
+    auto respawned = registry.spawn_entity();
+
+    REQUIRE(respawned.index() == stale[1].index());
+    REQUIRE_FALSE(registry.get_component<int>().contains(respawned));
+    registry.add_component<int>(respawned, 4);
+    registry.remove_component<int>(stale[1]);
+    REQUIRE(registry.get_component<int>()[respawned] == 4);
+}
+
+TEST_CASE("entity from index", "[Entities]")
+{
+    ecs::registry registry;
+    auto entity = registry.entity_from_index(5);
+
+    REQUIRE(entity == 5);
+    REQUIRE_THROWS_AS(registry.entity_from_index(5), std::runtime_error);
+    REQUIRE(registry.entity_from_index(2) == 2);
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(registry.spawn_entity() < 5);
+    REQUIRE(registry.spawn_entity() == 6);
+}
+
+TEST_CASE("Registry entities from a range", "[Registry]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+
+    registry.entity_from_index(12);
+    REQUIRE_THROWS_AS(registry.entities_from_range(10, 20, std::back_inserter(entities)), std::runtime_error);
+    REQUIRE(entities.empty());
+    REQUIRE(registry.valid(registry.entity_from_index(10)));
+    registry.entities_from_range(100, 110, std::back_inserter(entities));
+    REQUIRE(entities.size() == 10);
+    REQUIRE(entities.front() == 100);
+    registry.kill_entity(entities[3]);
+    REQUIRE(registry.entity_from_index(103).generation() == 1);
+    for (int i = 0; i < 1000; ++i) {
+        auto entity = registry.spawn_entity();
+
+        REQUIRE(entity != 10);
+        REQUIRE(entity != 12);
+        REQUIRE((entity < 100 || entity >= 110));
+    }
+}
+
+TEST_CASE("Registry batch spawn and kill", "[Registry]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+    auto &pool = registry.register_component<int>();
+
+    registry.spawn_entities(1000, std::back_inserter(entities));
+    REQUIRE(entities.size() == 1000);
+    registry.emplace_n<int>(entities, 7);
+    REQUIRE(pool.count() == 1000);
+    registry.kill_entities(std::vector<ecs::entity>(entities.begin(), entities.begin() + 500));
+    REQUIRE(pool.count() == 500);
+    REQUIRE_FALSE(registry.valid(entities[0]));
+    REQUIRE(registry.valid(entities[500]));
+    entities.clear();
+    registry.spawn_entities(600, std::back_inserter(entities));
+    REQUIRE(registry.get_component<int>().size() == 1000);
+    for (auto const &e : entities)
+        REQUIRE_FALSE(pool.contains(e));
+}
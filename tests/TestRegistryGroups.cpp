@@ -0,0 +1,113 @@
+#include <vector>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <registry.hpp>
+
+struct body {
+    float x;
+};
+
+struct shape {
+    int sides;
+};
+
+struct impact {
+    int damage;
+};
+
+template<>
+struct ecs::component_storage<shape>
+{
+    using type = ecs::containers::sparse_set<shape>;
+};
+
+template<>
+struct ecs::component_storage<impact>
+{
+    using type = ecs::containers::transient_set<impact>;
+};
+
+static std::vector<std::size_t> indexes(ecs::entity_group<body, shape const> const &group)
+{
+    std::vector<std::size_t> result;
+
+    for (auto const &e : group)
+        result.push_back(e.index());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST_CASE("Group entities owning components", "[Groups]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+
+    registry.register_component<body>();
+    registry.register_component<shape>();
+    registry.spawn_entities(4, std::back_inserter(entities));
+    registry.add_component<body>(entities[0], body{ 0 });
+    registry.add_component<shape>(entities[0], shape{ 3 });
+    registry.add_component<body>(entities[1], body{ 1 });
+
+    auto &group = registry.group<body, shape const>();
+
+    REQUIRE(&group == &registry.group<body, shape const>());
+    REQUIRE(indexes(group) == std::vector<std::size_t>{ entities[0].index() });
+    registry.add_component<shape>(entities[1], shape{ 4 });
+    registry.emplace_n<body>(std::vector<ecs::entity>{ entities[2], entities[3] }, body{ 2 });
+    registry.add_component<shape>(entities[3], shape{ 5 });
+    REQUIRE(indexes(group) == std::vector<std::size_t>{
+        entities[0].index(), entities[1].index(), entities[3].index()
+    });
+    registry.remove_component<shape>(entities[0]);
+    registry.kill_entity(entities[3]);
+    REQUIRE(indexes(group) == std::vector<std::size_t>{ entities[1].index() });
+    REQUIRE(group.contains(entities[1]));
+    REQUIRE_FALSE(group.contains(entities[3]));
+
+    int sides = 0;
+
+    group.each([&sides](ecs::entity const &, body &b, shape const &s) {
+        b.x = 10;
+        sides += s.sides;
+    });
+    REQUIRE(sides == 4);
+    REQUIRE(registry.get_component<body>()[entities[1]]->x == 10);
+}
+
+TEST_CASE("Groups follow copies, loads and transient components", "[Groups]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+    std::stringstream snapshot;
+
+    registry.register_component<body>();
+    registry.register_component<shape>();
+    registry.register_component<impact>();
+    registry.spawn_entities(2, std::back_inserter(entities));
+    registry.add_component<body>(entities[0], body{ 0 });
+    registry.add_component<shape>(entities[0], shape{ 3 });
+    registry.save(snapshot);
+
+    auto &group = registry.group<body, shape const>();
+    auto &hits = registry.group<impact>();
+
+    ecs::registry copy(registry);
+
+    registry.add_component<impact>(entities[1], impact{ 1 });
+    REQUIRE(hits.size() == 1);
+    registry.run_systems(0);
+    REQUIRE(hits.empty());
+
+    copy.add_component<body>(entities[1], body{ 1 });
+    copy.add_component<shape>(entities[1], shape{ 4 });
+    REQUIRE(copy.group<body, shape const>().size() == 2);
+    REQUIRE(group.size() == 1);
+
+    registry.remove_component<body>(entities[0]);
+    REQUIRE(group.empty());
+    registry.load(snapshot);
+    REQUIRE(indexes(group) == std::vector<std::size_t>{ entities[0].index() });
+}
@@ -0,0 +1,76 @@
+#include <vector>
+#include <iterator>
+#include <stdexcept>
+#include <catch2/catch_test_macros.hpp>
+#include <registry.hpp>
+
+struct cell {
+    int x;
+    int y;
+};
+
+struct tag {
+    int value;
+};
+
+template<>
+struct ecs::component_storage<tag>
+{
+    using type = ecs::containers::sparse_set<tag>;
+};
+
+TEST_CASE("Publish construct and update signals", "[Signals]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+    std::vector<std::size_t> constructed;
+    std::vector<std::size_t> updated;
+
+    registry.register_component<cell>();
+    registry.register_component<tag>();
+    registry.spawn_entities(3, std::back_inserter(entities));
+    registry.on_construct<cell>().connect([&constructed](ecs::registry &r, ecs::entity const &e) {
+        REQUIRE(r.get_component<cell>().contains(e));
+        constructed.push_back(e.index());
+    });
+    registry.on_update<cell>().connect([&updated](ecs::registry &, ecs::entity const &e) {
+        updated.push_back(e.index());
+    });
+    registry.add_component<cell>(entities[0], cell{ 1, 1 });
+    registry.emplace_component<cell>(entities[0], cell{ 2, 2 });
+    registry.emplace_n<cell>(std::vector<ecs::entity>{ entities[1], entities[2] }, cell{ 3, 3 });
+    registry.patch<cell>(entities[1], [](cell &c) { c.x = 4; });
+    registry.add_component<tag>(entities[0], tag{ 0 });
+    REQUIRE(constructed == std::vector<std::size_t>{ entities[0].index(), entities[1].index(), entities[2].index() });
+    REQUIRE(updated == std::vector<std::size_t>{ entities[0].index(), entities[1].index() });
+    REQUIRE(registry.get_component<cell>()[entities[1]]->x == 4);
+    REQUIRE_THROWS_AS(registry.patch<tag>(entities[1], [](tag &) {}), std::out_of_range);
+}
+
+TEST_CASE("Publish destroy signals", "[Signals]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+    std::vector<int> destroyed;
+
+    registry.register_component<cell>();
+    registry.register_component<tag>();
+    registry.spawn_entities(3, std::back_inserter(entities));
+    registry.add_component<tag>(entities[0], tag{ 0 });
+    registry.add_component<tag>(entities[1], tag{ 1 });
+    registry.add_component<tag>(entities[2], tag{ 2 });
+
+    auto const connection = registry.on_destroy<tag>().connect([&destroyed](ecs::registry &r, ecs::entity const &e) {
+        destroyed.push_back(r.get_component<tag>().get(e).value);
+    });
+
+    registry.remove_component<tag>(entities[0]);
+    registry.remove_component<tag>(entities[0]);
+    registry.remove_component<cell>(entities[1]);
+    registry.kill_entity(entities[1]);
+    REQUIRE(destroyed == std::vector<int>{ 0, 1 });
+    REQUIRE(registry.on_destroy<tag>().disconnect(connection));
+    REQUIRE(registry.on_destroy<tag>().empty());
+    registry.kill_entity(entities[2]);
+    REQUIRE(destroyed.size() == 2);
+}
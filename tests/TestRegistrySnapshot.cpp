@@ -0,0 +1,313 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sstream>
+#include <typeinfo>
+#include <iterator>
+#include <catch2/catch_test_macros.hpp>
+#include <registry.hpp>
+#include <exceptions/snapshot_exception.hpp>
+#include <exceptions/changes_not_tracked_exception.hpp>
+
+struct waypoint {
+    float x;
+    float y;
+};
+
+struct cooldown {
+    int frames;
+};
+
+struct label {
+    std::string text;
+};
+
+struct handle {
+    std::string path;
+};
+
+template<>
+struct ecs::component_storage<cooldown>
+{
+    using type = ecs::containers::sparse_set<cooldown>;
+};
+
+template<>
+struct ecs::snapshot::codec<label>
+{
+    static void write(std::ostream &out, label const &l)
+    {
+        const std::uint64_t length = l.text.size();
+
+        out.write(reinterpret_cast<char const *>(&length), sizeof(length));
+        out.write(l.text.data(), static_cast<std::streamsize>(length));
+    }
+
+    static label read(std::istream &in)
+    {
+        std::uint64_t length = 0;
+        label l;
+
+        in.read(reinterpret_cast<char *>(&length), sizeof(length));
+        l.text.resize(length);
+        in.read(l.text.data(), static_cast<std::streamsize>(length));
+        return l;
+    }
+};
+
+static void register_components(ecs::registry &registry)
+{
+    registry.register_component<waypoint>();
+    registry.register_component<cooldown>();
+    registry.register_component<label>();
+}
+
+TEST_CASE("Save and load a registry", "[Snapshot]")
+{
+    ecs::registry source;
+    ecs::registry destination;
+    std::vector<ecs::entity> entities;
+    std::stringstream stream;
+
+    register_components(source);
+    register_components(destination);
+    source.spawn_entities(6000, std::back_inserter(entities));
+    for (std::size_t i = 0; i < entities.size(); i += 2)
+        source.add_component<waypoint>(entities[i], waypoint{ static_cast<float>(i), 1 });
+    source.add_component<cooldown>(entities[5], cooldown{ 3 });
+    source.add_component<cooldown>(entities[4097], cooldown{ 4 });
+    source.add_component<label>(entities[1], label{ "first" });
+    source.kill_entity(entities[2]);
+    source.save(stream);
+
+    auto const other = destination.spawn_entity();
+
+    destination.add_component<waypoint>(other, waypoint{ 1, 1 });
+    destination.load(stream);
+    REQUIRE_FALSE(destination.valid(entities[2]));
+    REQUIRE(destination.valid(entities[4]));
+    REQUIRE(destination.get_component<waypoint>().count() == 2999);
+    REQUIRE(destination.get_component<waypoint>()[entities[5998]]->x == 5998);
+    REQUIRE(destination.get_component<cooldown>()[entities[4097]].frames == 4);
+    REQUIRE(destination.get_component<cooldown>().entities() == source.get_component<cooldown>().entities());
+    REQUIRE(destination.get_component<label>()[entities[1]]->text == "first");
+
+    auto const respawned = destination.spawn_entity();
+
+    REQUIRE(respawned.index() == entities[2].index());
+    REQUIRE(respawned != entities[2]);
+}
+
+TEST_CASE("Load a snapshot holding an unregistered component", "[Snapshot]")
+{
+    ecs::registry source;
+    ecs::registry destination;
+    std::stringstream stream;
+
+    register_components(source);
+    destination.register_component<waypoint>();
+    source.add_component<label>(source.spawn_entity(), label{ "lost" });
+    source.save(stream);
+    REQUIRE_THROWS_AS(destination.load(stream), ecs::exceptions::snapshot_exception);
+}
+
+TEST_CASE("Load a truncated snapshot", "[Snapshot]")
+{
+    ecs::registry source;
+    ecs::registry destination;
+    std::stringstream stream;
+
+    register_components(source);
+    register_components(destination);
+    source.add_component<waypoint>(source.spawn_entity(), waypoint{ 1, 2 });
+    source.save(stream);
+
+    std::string bytes = stream.str();
+    auto const e = destination.spawn_entity();
+
+    destination.add_component<waypoint>(e, waypoint{ 3, 4 });
+    bytes.resize(bytes.size() - 4);
+    stream.str(bytes);
+    REQUIRE_THROWS_AS(destination.load(stream), ecs::exceptions::snapshot_exception);
+    REQUIRE_FALSE(destination.valid(e));
+    REQUIRE(destination.get_component<waypoint>().count() == 0);
+}
+
+TEST_CASE("Load a snapshot with corrupted positions", "[Snapshot]")
+{
+    ecs::registry source;
+    ecs::registry destination;
+    std::stringstream stream;
+
+    register_components(source);
+    register_components(destination);
+    source.add_component<waypoint>(source.spawn_entity(), waypoint{ 1, 2 });
+    source.save(stream);
+
+    const std::string bytes = stream.str();
+    const std::string name = typeid(waypoint).name();
+    const std::size_t count = bytes.find(name) + name.size();
+    const std::uint64_t huge = std::uint64_t{1} << 60;
+    const std::uint64_t outside = 1000;
+    std::string corrupted = bytes;
+
+    corrupted.replace(count, sizeof(huge), reinterpret_cast<char const *>(&huge), sizeof(huge));
+    stream.str(corrupted);
+    REQUIRE_THROWS_AS(destination.load(stream), ecs::exceptions::snapshot_exception);
+    corrupted = bytes;
+    corrupted.replace(count + sizeof(std::uint64_t), sizeof(outside), reinterpret_cast<char const *>(&outside),
+        sizeof(outside));
+    stream.clear();
+    stream.str(corrupted);
+    REQUIRE_THROWS_AS(destination.load(stream), ecs::exceptions::snapshot_exception);
+    REQUIRE(destination.get_component<waypoint>().count() == 0);
+    stream.clear();
+    stream.str(bytes);
+    destination.load(stream);
+    REQUIRE(destination.get_component<waypoint>().count() == 1);
+}
+
+TEST_CASE("Load a snapshot with a corrupted free list", "[Snapshot]")
+{
+    ecs::registry source;
+    ecs::registry destination;
+    std::vector<ecs::entity> entities;
+    std::stringstream stream;
+
+    source.spawn_entities(3, std::back_inserter(entities));
+    source.kill_entity(entities[1]);
+    source.kill_entity(entities[2]);
+    source.save(stream);
+
+    // Magic and version, then the number of slots, the slots, the previous links, the head and the length.
+    const std::string bytes = stream.str();
+    const std::size_t slots = 8 + sizeof(std::uint64_t);
+    const std::size_t freeCount = slots + 3 * sizeof(std::uint64_t) + 3 * sizeof(std::uint32_t) + sizeof(std::uint32_t);
+    const std::uint32_t cycle = 2;
+    const std::uint64_t length = 1;
+    std::string corrupted = bytes;
+
+    corrupted.replace(slots + sizeof(std::uint64_t), sizeof(cycle), reinterpret_cast<char const *>(&cycle),
+        sizeof(cycle));
+    stream.str(corrupted);
+    REQUIRE_THROWS_AS(destination.load(stream), ecs::exceptions::snapshot_exception);
+    corrupted = bytes;
+    corrupted.replace(freeCount, sizeof(length), reinterpret_cast<char const *>(&length), sizeof(length));
+    stream.clear();
+    stream.str(corrupted);
+    REQUIRE_THROWS_AS(destination.load(stream), ecs::exceptions::snapshot_exception);
+    stream.clear();
+    stream.str(bytes);
+    destination.load(stream);
+    REQUIRE(destination.valid(entities[0]));
+    REQUIRE(destination.spawn_entity().index() == entities[2].index());
+    REQUIRE(destination.spawn_entity().index() == entities[1].index());
+}
+
+TEST_CASE("Load a snapshot with a corrupted number of entity slots", "[Snapshot]")
+{
+    ecs::registry source;
+    ecs::registry destination;
+    std::vector<ecs::entity> entities;
+    std::stringstream stream;
+
+    source.spawn_entities(3, std::back_inserter(entities));
+    source.save(stream);
+
+    // Magic and version, then the number of slots.
+    const std::string bytes = stream.str();
+    const std::size_t slots = 8;
+    const std::uint64_t inflated = 0xfffffffe;
+    std::string corrupted = bytes;
+
+    corrupted.replace(slots, sizeof(inflated), reinterpret_cast<char const *>(&inflated), sizeof(inflated));
+    stream.str(corrupted);
+    REQUIRE_THROWS_AS(destination.load(stream), ecs::exceptions::snapshot_exception);
+    stream.clear();
+    stream.str(bytes.substr(0, slots + sizeof(std::uint64_t) + 2 * sizeof(std::uint64_t)));
+    REQUIRE_THROWS_AS(destination.load(stream), ecs::exceptions::snapshot_exception);
+    stream.clear();
+    stream.str(bytes);
+    destination.load(stream);
+    REQUIRE(destination.valid(entities[2]));
+}
+
+TEST_CASE("Track the changes of a component outside of a sparse_array", "[Snapshot]")
+{
+    ecs::component_pool<ecs::component_storage_t<cooldown>> pool;
+    std::stringstream delta;
+
+    REQUIRE_FALSE(pool.tracks_changes());
+    REQUIRE_THROWS_AS(pool.track_changes(true), ecs::exceptions::changes_not_tracked_exception);
+    REQUIRE_THROWS_AS(pool.load_changes(delta, 1), ecs::exceptions::changes_not_tracked_exception);
+}
+
+TEST_CASE("Save a component without codec", "[Snapshot]")
+{
+    ecs::registry registry;
+    std::stringstream stream;
+
+    registry.register_component<handle>();
+    REQUIRE_THROWS_AS(registry.save(stream), ecs::exceptions::snapshot_exception);
+}
+
+TEST_CASE("Diff components since a tick", "[Snapshot]")
+{
+    ecs::registry registry;
+    std::vector<ecs::entity> entities;
+
+    register_components(registry);
+    registry.track_changes<waypoint>();
+    registry.spawn_entities(4, std::back_inserter(entities));
+    registry.add_component<waypoint>(entities[0], waypoint{ 0, 0 });
+    registry.add_component<waypoint>(entities[1], waypoint{ 1, 1 });
+    registry.add_component<cooldown>(entities[0], cooldown{ 1 });
+    registry.run_systems(0);
+
+    const auto since = registry.tick();
+
+    registry.get_component<waypoint>()[entities[1]]->x = 2;
+    registry.add_component<waypoint>(entities[2], waypoint{ 3, 3 });
+    registry.kill_entity(entities[0]);
+
+    auto const changes = registry.diff(since);
+
+    REQUIRE(changes.size() == 1);
+    REQUIRE(changes[0].type == typeid(waypoint));
+    REQUIRE(changes[0].added == std::vector<std::size_t>{ entities[2].index() });
+    REQUIRE(changes[0].changed == std::vector<std::size_t>{ entities[1].index() });
+    REQUIRE(changes[0].removed == std::vector<std::size_t>{ entities[0].index() });
+    REQUIRE(registry.diff(registry.tick() + 1).empty());
+}
+
+TEST_CASE("Apply a delta snapshot", "[Snapshot]")
+{
+    ecs::registry source;
+    ecs::registry replica;
+    std::vector<ecs::entity> entities;
+    std::stringstream full;
+    std::stringstream delta;
+
+    register_components(source);
+    register_components(replica);
+    source.track_changes<waypoint>();
+    source.track_changes<label>();
+    source.spawn_entities(3, std::back_inserter(entities));
+    source.add_component<waypoint>(entities[0], waypoint{ 0, 0 });
+    source.add_component<waypoint>(entities[1], waypoint{ 1, 1 });
+    source.add_component<label>(entities[2], label{ "old" });
+    source.save(full);
+    replica.load(full);
+    source.run_systems(0);
+
+    const auto since = source.tick();
+
+    source.get_component<waypoint>()[entities[1]]->y = 5;
+    source.remove_component<waypoint>(entities[0]);
+    source.get_component<label>()[entities[2]]->text = "new";
+    source.save_changes(delta, since);
+    replica.load_changes(delta);
+    REQUIRE_FALSE(replica.get_component<waypoint>().contains(entities[0]));
+    REQUIRE(replica.get_component<waypoint>()[entities[1]]->y == 5);
+    REQUIRE(replica.get_component<label>()[entities[2]]->text == "new");
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <registry.hpp>
+#include <zipper.hpp>
 
 struct A {};
 
@@ -16,3 +17,110 @@ TEST_CASE("Systems run", "[Systems]")
     });
     registry.run_systems(0);
 }
+
+struct counter {
+    int value;
+};
+
+struct total {
+    int value;
+};
+
+TEST_CASE("Systems run concurrently in serial order", "[Systems]")
+{
+    ecs::registry registry;
+
+    registry.register_component<counter>();
+    registry.register_component<total>();
+    for (int i = 0; i < 100; ++i) {
+        auto entity = registry.spawn_entity();
+
+        registry.add_component<counter>(entity, {i});
+        registry.add_component<total>(entity, {0});
+    }
+    registry.set_concurrency(4);
+    for (int step = 0; step < 10; ++step) {
+        registry.add_system<counter>([](ecs::registry &, double, ecs::containers::sparse_array<counter> &counters) {
+            for (auto &c : counters)
+                c->value *= 2;
+        });
+        registry.add_system<counter const, total>([](
+            ecs::registry &,
+            double,
+            ecs::containers::sparse_array<counter> const &counters,
+            ecs::containers::sparse_array<total> &totals)
+        {
+            for (std::size_t i = 0; i < counters.size(); ++i)
+                totals[i]->value += counters[i]->value;
+        });
+    }
+    registry.run_systems(0);
+
+    auto const &totals = registry.get_component<total>();
+
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(totals[i]->value == i * 2046);
+}
+
+TEST_CASE("Systems exception is rethrown", "[Systems]")
+{
+    ecs::registry registry;
+
+    registry.register_component<counter>();
+    registry.set_concurrency(2);
+    registry.add_system<counter const>([](ecs::registry &, double, ecs::containers::sparse_array<counter> const &) {
+        throw std::runtime_error("system failure");
+    });
+    registry.add_system<counter const>([](ecs::registry &, double, ecs::containers::sparse_array<counter> const &) {});
+    REQUIRE_THROWS_AS(registry.run_systems(0), std::runtime_error);
+}
+
+struct collision {
+    int other;
+
+    explicit collision(int other) : other(other) {};
+};
+
+template<>
+struct ecs::component_storage<collision>
+{
+    using type = ecs::containers::transient_set<collision>;
+};
+
+TEST_CASE("Transient components are cleared after the systems", "[Systems]")
+{
+    ecs::registry registry;
+    auto first = registry.spawn_entity();
+    auto second = registry.spawn_entity();
+    int consumed = 0;
+
+    registry.register_component<counter>();
+    registry.register_component<collision>();
+    registry.emplace_component<counter>(first, counter{ 0 });
+    registry.emplace_component<counter>(second, counter{ 0 });
+    registry.add_system<collision>([first, second](
+        ecs::registry &,
+        double,
+        ecs::containers::transient_set<collision> &collisions)
+    {
+        collisions.emplace_at(first, 2);
+        collisions.emplace_at(second, 1);
+    });
+    registry.add_system<counter, collision const>([&consumed](
+        ecs::registry &,
+        double,
+        ecs::containers::sparse_array<counter> &counters,
+        ecs::containers::transient_set<collision> const &collisions)
+    {
+        for (auto &&[c, hit] : ecs::containers::zipper(counters, collisions)) {
+            c.value += hit.other;
+            ++consumed;
+        }
+    });
+    registry.run_systems(0);
+    registry.run_systems(0);
+    REQUIRE(consumed == 4);
+    REQUIRE(registry.get_component<counter>()[first]->value == 4);
+    REQUIRE(registry.get_component<collision>().empty());
+    REQUIRE_FALSE(registry.get_component<collision>().contains(second));
+}
@@ -0,0 +1,202 @@
+#include <vector>
+#include <cstdint>
+#include <sstream>
+#include <iterator>
+#include <catch2/catch_test_macros.hpp>
+#include <registry.hpp>
+#include <zipper.hpp>
+#include <indexed_zipper.hpp>
+
+struct point {
+    float x;
+    float y;
+};
+
+struct motion {
+    float dx;
+    float dy;
+};
+
+struct layer {
+    int depth;
+};
+
+template<>
+struct ecs::soa_fields<point>
+{
+    static constexpr auto members = std::make_tuple(&point::x, &point::y);
+};
+
+template<>
+struct ecs::soa_fields<motion>
+{
+    static constexpr auto members = std::make_tuple(&motion::dx, &motion::dy);
+};
+
+template<>
+struct ecs::component_storage<point>
+{
+    using type = ecs::containers::soa_array<point>;
+};
+
+template<>
+struct ecs::component_storage<motion>
+{
+    using type = ecs::containers::soa_array<motion>;
+};
+
+TEST_CASE("Insert, access and erase", "[soa_array]")
+{
+    ecs::containers::soa_array<point> arr;
+
+    arr.insert_at(3, point{ 1, 2 });
+    arr.emplace_at(5000, 3.f, 4.f);
+    REQUIRE(arr.count() == 2);
+    REQUIRE(arr.size() == 5001);
+    REQUIRE(arr.contains(3));
+    REQUIRE_FALSE(arr.contains(4));
+    REQUIRE(arr.next(4) == 5000);
+    REQUIRE(arr.column<0>(1) == nullptr);
+
+    point const p = arr.get(3);
+
+    REQUIRE(p.x == 1);
+    REQUIRE(p.y == 2);
+    REQUIRE(arr[5000].field<&point::y>() == 4);
+    arr[3] = point{ 7, 8 };
+    arr.get(3).get<0>() += 1;
+    REQUIRE(arr.get(3).get<0>() == 8);
+    REQUIRE(arr.get(3).get<1>() == 8);
+    arr.insert_at(3, point{ 0, 0 });
+    REQUIRE(arr.count() == 2);
+    arr.erase(3);
+    arr.erase(3);
+    REQUIRE(arr.count() == 1);
+    REQUIRE_FALSE(arr.contains(3));
+    arr.clear();
+    REQUIRE(arr.count() == 0);
+    REQUIRE_FALSE(arr.contains(5000));
+}
+
+TEST_CASE("Fields are stored in aligned columns", "[soa_array]")
+{
+    ecs::containers::soa_array<point> positions;
+    ecs::containers::soa_array<motion> motions;
+    std::vector<std::size_t> indexes;
+
+    for (std::size_t i = 0; i < 3000; i += 3)
+        indexes.push_back(i);
+    positions.emplace_n(indexes.begin(), indexes.end(), 1.f, 2.f);
+    motions.emplace_n(indexes.begin(), indexes.end(), 0.5f, -1.f);
+    REQUIRE(positions.pages() == 3);
+    for (std::size_t page = 0; page < positions.pages(); ++page) {
+        float *x = positions.column<0>(page);
+        float *y = positions.column<1>(page);
+        float const *dx = motions.column<0>(page);
+        float const *dy = motions.column<1>(page);
+
+        REQUIRE(reinterpret_cast<std::uintptr_t>(x) % positions.alignment == 0);
+        for (std::size_t i = 0; i < positions.page_size; ++i) {
+            x[i] += dx[i] * 2;
+            y[i] += dy[i] * 2;
+        }
+    }
+    REQUIRE(positions.get(2997).get<0>() == 2);
+    REQUIRE(positions.get(2997).get<1>() == 0);
+}
+
+TEST_CASE("Copy and move a soa_array", "[soa_array]")
+{
+    ecs::containers::soa_array<point> arr;
+
+    arr.insert_at(10, point{ 1, 2 });
+
+    auto copy = arr;
+    auto moved = std::move(arr);
+
+    copy.get(10).get<0>() = 5;
+    REQUIRE(moved.get(10).get<0>() == 1);
+    REQUIRE(copy.count() == 1);
+    REQUIRE(arr.count() == 0);
+    arr = copy;
+    REQUIRE(arr.get(10).get<0>() == 5);
+}
+
+TEST_CASE("zipper hands out references to the fields", "[soa_array]")
+{
+    ecs::containers::soa_array<point> positions;
+    ecs::containers::soa_array<motion> motions;
+    ecs::containers::sparse_array<layer> layers;
+
+    for (std::size_t i = 0; i < 100; ++i) {
+        positions.insert_at(i, point{ static_cast<float>(i), 0 });
+        if (i % 2 == 0)
+            motions.insert_at(i, motion{ 1, 2 });
+        if (i % 4 == 0)
+            layers.insert_at(i, layer{ 1 });
+    }
+    for (auto &&[pos, mot] : ecs::containers::zipper(positions, std::as_const(motions))) {
+        auto &&[x, y] = pos;
+
+        x += mot.get<0>();
+        y += mot.field<&motion::dy>();
+    }
+    REQUIRE(positions.get(4).get<0>() == 5);
+    REQUIRE(positions.get(4).get<1>() == 2);
+    REQUIRE(positions.get(5).get<0>() == 5);
+
+    std::size_t count = 0;
+
+    for (auto &&[index, pos, l] : ecs::containers::indexed_zipper(
+        positions, ecs::containers::exclude(layers), ecs::containers::maybe(motions))) {
+        REQUIRE(index % 4 != 0);
+        REQUIRE(l.has_value() == (index % 2 == 0));
+        if (l)
+            *l = motion{ 0, 0 };
+        count++;
+    }
+    REQUIRE(count == 75);
+    REQUIRE(motions.get(2).get<0>() == 0);
+    REQUIRE(motions.get(4).get<0>() == 1);
+}
+
+TEST_CASE("Registry stores soa_array components", "[soa_array]")
+{
+    ecs::registry source;
+    ecs::registry destination;
+    std::vector<ecs::entity> entities;
+    std::stringstream stream;
+
+    source.register_component<point>();
+    source.register_component<motion>();
+    destination.register_component<point>();
+    destination.register_component<motion>();
+    source.spawn_entities(2000, std::back_inserter(entities));
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        source.add_component<point>(entities[i], point{ static_cast<float>(i), 0 });
+        if (i % 2)
+            source.emplace_component<motion>(entities[i], 1.f, 1.f);
+    }
+    source.add_system<point, motion const>([](ecs::registry &, double dt,
+        ecs::containers::soa_array<point> &positions, ecs::containers::soa_array<motion> const &motions) {
+        for (auto &&[pos, mot] : ecs::containers::zipper(positions, motions))
+            pos = point{ pos.get<0>() + mot.get<0>() * static_cast<float>(dt), pos.get<1>() + mot.get<1>() };
+    });
+    source.run_systems(2);
+    source.patch<point>(entities[0], [](auto pos) {
+        pos.template get<1>() = 5;
+    });
+    source.kill_entity(entities[3]);
+    source.save(stream);
+    destination.load(stream);
+
+    auto &positions = destination.get_component<point>();
+
+    REQUIRE(positions.count() == 1999);
+    REQUIRE(destination.get_component<motion>().count() == 999);
+    REQUIRE(positions.get(entities[1].index()).get<0>() == 3);
+    REQUIRE(positions.get(entities[1].index()).get<1>() == 1);
+    REQUIRE(positions.get(entities[0].index()).get<1>() == 5);
+    REQUIRE(positions.get(entities[2].index()).get<0>() == 2);
+    REQUIRE_FALSE(positions.contains(entities[3].index()));
+}
@@ -1,5 +1,8 @@
+#include <vector>
+#include <utility>
 #include <catch2/catch_test_macros.hpp>
 #include <registry.hpp>
+#include <memory_resource.hpp>
 
 TEST_CASE("Begin", "[sparse_array]")
 {
@@ -64,3 +67,148 @@ TEST_CASE("Emplace", "[sparse_array]")
     arr.emplace_at(2, 1);
     REQUIRE(arr[2] == 1);
 }
+
+TEST_CASE("References stay valid when growing", "[sparse_array]")
+{
+    ecs::containers::sparse_array<int> arr;
+    auto &first = arr.insert_at(0, 42);
+
+    arr.emplace_at(1000000, 1);
+    REQUIRE(arr.size() == 1000001);
+    REQUIRE(&first == &arr[0]);
+    REQUIRE(first == 42);
+}
+
+TEST_CASE("Holes are not stored", "[sparse_array]")
+{
+    ecs::containers::sparse_array<int> arr;
+    auto const &constArr = arr;
+
+    arr.emplace_at(5000000, 1);
+    REQUIRE_FALSE(arr.contains(10));
+    REQUIRE(constArr[10] == std::nullopt);
+    REQUIRE(arr.getIndex(constArr[5000000]) == 5000000);
+}
+
+TEST_CASE("Count stored components", "[sparse_array]")
+{
+    ecs::containers::sparse_array<int> arr;
+
+    arr.emplace_at(3, 1);
+    arr.insert_at(3, 2);
+    arr.insert_at(5000, 3);
+    arr.erase(3);
+    arr.erase(3);
+    REQUIRE(arr.count() == 1);
+    REQUIRE(arr.next(0) == 5000);
+    REQUIRE(arr.next(5001) == arr.size());
+}
+
+TEST_CASE("Clear sparse_array", "[sparse_array]")
+{
+    ecs::containers::sparse_array<int> arr;
+
+    arr.reserve(3000);
+    arr.emplace_at(2000, 1);
+    arr.emplace_at(10, 1);
+    arr.clear();
+    REQUIRE(arr.count() == 0);
+    REQUIRE(arr.size() == 0);
+    REQUIRE_FALSE(arr.contains(10));
+    arr.emplace_at(10, 2);
+    REQUIRE(arr.count() == 1);
+}
+
+TEST_CASE("Erase a range of positions", "[sparse_array]")
+{
+    ecs::containers::sparse_array<int> arr;
+    std::vector<std::size_t> removed;
+    const std::vector<std::size_t> positions = { 3, 5, 70, 4, 9000, 3, 100000 };
+
+    for (int i = 0; i < 80; ++i)
+        arr.emplace_at(i, i);
+    arr.track_changes();
+    arr.set_tick(1);
+    arr.erase_range(positions.begin(), positions.end());
+    arr.each_removal(1, [&removed](std::size_t pos) { removed.push_back(pos); });
+    REQUIRE(arr.count() == 76);
+    REQUIRE(removed == std::vector<std::size_t>{ 3, 5, 70, 4 });
+    REQUIRE_FALSE(arr.contains(4));
+    REQUIRE(arr.next(3) == 6);
+    REQUIRE(arr.next(70) == 71);
+    arr.emplace_at(5, 1);
+    REQUIRE(arr.count() == 77);
+}
+
+TEST_CASE("Allocate sparse_array from a memory resource", "[sparse_array]")
+{
+    ecs::pmr::arena arena;
+    ecs::pmr::pool pool;
+    ecs::pmr::sparse_array<int> arr(&arena);
+
+    arr.emplace_at(4100, 1);
+    arr.emplace_at(3, 2);
+    REQUIRE(arr.get_allocator().resource() == &arena);
+
+    ecs::pmr::sparse_array<int> copy(arr, &pool);
+
+    REQUIRE(copy.get_allocator().resource() == &pool);
+    REQUIRE(copy.count() == 2);
+    REQUIRE(copy.next(4) == 4100);
+
+    ecs::pmr::sparse_array<int> moved(&pool);
+
+    moved = std::move(arr);
+    REQUIRE(moved.get_allocator().resource() == &pool);
+    REQUIRE(moved.count() == 2);
+    REQUIRE(*moved[3] == 2);
+    REQUIRE(arr.count() == 0);
+    REQUIRE_FALSE(arr.contains(3));
+}
+
+TEST_CASE("Track sparse_array changes", "[sparse_array]")
+{
+    ecs::containers::sparse_array<int> arr;
+    std::vector<std::size_t> added;
+    std::vector<std::size_t> changed;
+    std::vector<std::size_t> removed;
+    auto const collect = [&](std::size_t pos, bool isNew) {
+        (isNew ? added : changed).push_back(pos);
+    };
+
+    arr.emplace_at(11, 0);
+    arr.track_changes();
+    arr.set_tick(1);
+    arr.emplace_at(3, 1);
+    arr.emplace_at(5000, 2);
+    arr.emplace_at(7, 3);
+    arr.set_tick(2);
+    arr.get(7) += 1;
+    arr.emplace_at(9, 4);
+    arr.erase(3);
+    arr.each_change(2, collect);
+    arr.each_removal(2, [&removed](std::size_t pos) { removed.push_back(pos); });
+    REQUIRE(added == std::vector<std::size_t>{ 9 });
+    REQUIRE(changed == std::vector<std::size_t>{ 7 });
+    REQUIRE(removed == std::vector<std::size_t>{ 3 });
+
+    added.clear();
+    changed.clear();
+    (void) std::as_const(arr).get(5000);
+    arr.set_tick(3);
+    arr.each_change(3, collect);
+    REQUIRE(added.empty());
+    REQUIRE(changed.empty());
+    arr.discard_removals(3);
+    removed.clear();
+    arr.each_removal(0, [&removed](std::size_t pos) { removed.push_back(pos); });
+    REQUIRE(removed.empty());
+
+    arr.track_changes(false);
+    arr.get(9) += 1;
+    arr.erase(7);
+    arr.each_change(3, collect);
+    arr.each_removal(0, [&removed](std::size_t pos) { removed.push_back(pos); });
+    REQUIRE(changed.empty());
+    REQUIRE(removed.empty());
+}
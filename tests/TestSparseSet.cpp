@@ -0,0 +1,144 @@
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <registry.hpp>
+#include <zipper.hpp>
+#include <indexed_zipper.hpp>
+
+struct stunned {
+    int duration;
+
+    explicit stunned(int duration) : duration(duration) {};
+};
+
+template<>
+struct ecs::component_storage<stunned>
+{
+    using type = ecs::containers::sparse_set<stunned>;
+};
+
+TEST_CASE("Insert and access", "[sparse_set]")
+{
+    ecs::containers::sparse_set<int> set;
+
+    set.insert_at(1000000, 15);
+    set.emplace_at(3, 20);
+    REQUIRE(set.size() == 2);
+    REQUIRE(set.contains(1000000));
+    REQUIRE(set.contains(3));
+    REQUIRE_FALSE(set.contains(4));
+    REQUIRE(set[1000000] == 15);
+    REQUIRE(set.at(3) == 20);
+    REQUIRE_THROWS_AS(set.at(4), std::out_of_range);
+}
+
+TEST_CASE("Insert over an existing component", "[sparse_set]")
+{
+    ecs::containers::sparse_set<int> set;
+
+    set.insert_at(2, 1);
+    set.insert_at(2, 5);
+    REQUIRE(set.size() == 1);
+    REQUIRE(set[2] == 5);
+}
+
+TEST_CASE("Erase swaps with the last component", "[sparse_set]")
+{
+    ecs::containers::sparse_set<int> set;
+
+    for (int i = 0; i < 10; ++i)
+        set.emplace_at(i * 10, i);
+    set.erase(20);
+    set.erase(21);
+    REQUIRE(set.size() == 9);
+    REQUIRE_FALSE(set.contains(20));
+    REQUIRE(set[90] == 9);
+    REQUIRE(set.getIndex(set[90]) == 90);
+    REQUIRE(set.entities()[2] == 90);
+}
+
+TEST_CASE("Dense iteration", "[sparse_set]")
+{
+    ecs::containers::sparse_set<int> set;
+    int sum = 0;
+
+    for (int i = 0; i < 10; ++i)
+        set.emplace_at(i * 1000, i);
+    for (auto const &e : set)
+        sum += e;
+    REQUIRE(sum == 45);
+}
+
+TEST_CASE("zipper over sparse_array and sparse_set", "[sparse_set]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_set<long> set;
+    std::size_t n = 0;
+
+    for (int i = 0; i < 20; ++i) {
+        arr.emplace_at(i, i);
+        if (i % 3 == 0)
+            set.emplace_at(i, i);
+    }
+    for (auto &&[entity, component1, component2] : ecs::containers::indexed_zipper(arr, set)) {
+        REQUIRE(entity % 3 == 0);
+        REQUIRE(component1 == component2);
+        n++;
+    }
+    REQUIRE(n == 7);
+}
+
+TEST_CASE("Registry component stored in a sparse_set", "[sparse_set]")
+{
+    ecs::registry registry;
+    auto &set = registry.register_component<stunned>();
+    auto entity = registry.spawn_entity();
+
+    REQUIRE(std::is_same<decltype(set), ecs::containers::sparse_set<stunned> &>::value);
+    registry.emplace_component<stunned>(entity, 3);
+    REQUIRE(set[entity].duration == 3);
+    registry.kill_entity(entity);
+    REQUIRE(set.empty());
+}
+
+TEST_CASE("sparse_set bulk insertion", "[sparse_set]")
+{
+    ecs::containers::sparse_set<int> set;
+    std::vector<std::size_t> positions{ 3, 9000, 1 };
+    std::vector<int> values{ 1, 2, 3 };
+
+    set.insert_range(positions.begin(), positions.end(), values.begin());
+    REQUIRE(set.size() == 3);
+    REQUIRE(set[9000] == 2);
+    set.emplace_n(positions.begin(), positions.begin() + 2, 5);
+    REQUIRE(set.size() == 3);
+    REQUIRE(set[3] == 5);
+}
+
+TEST_CASE("transient_set clear", "[sparse_set]")
+{
+    ecs::containers::transient_set<int> set;
+
+    set.emplace_at(5, 1);
+    set.emplace_at(9000, 2);
+    set.erase(5);
+    set.emplace_at(7, 3);
+    REQUIRE(set[7] == 3);
+    REQUIRE_FALSE(set.contains(5));
+    set.clear();
+    REQUIRE(set.empty());
+    REQUIRE_FALSE(set.contains(7));
+    REQUIRE_FALSE(set.contains(9000));
+    set.emplace_at(9000, 4);
+    REQUIRE(set.contains(9000));
+    REQUIRE_FALSE(set.contains(7));
+    REQUIRE(set.at(9000) == 4);
+
+    const std::vector<std::size_t> positions = { 7, 9000, 20000 };
+    const std::vector<int> values = { 5, 6, 7 };
+
+    set.insert_range(positions.begin(), positions.end(), values.begin());
+    REQUIRE(set.size() == 3);
+    REQUIRE(set[9000] == 6);
+    REQUIRE(set.extent() > 20000);
+    REQUIRE(set.entities() == std::vector<std::size_t>{ 9000, 7, 20000 });
+}
@@ -1,6 +1,8 @@
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
 #include <registry.hpp>
 #include <zipper.hpp>
+#include <indexed_zipper.hpp>
 
 TEST_CASE("zipper Iterate over single sparse_array", "[zipper]")
 {
@@ -57,3 +59,217 @@ TEST_CASE("zipper Iterate over multiple sparse_array (entity matching)", "[zippe
     else
         SUCCEED();
 }
+
+TEST_CASE("zipper parallel iteration", "[zipper]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_array<long> arr2;
+    ecs::thread_pool pool(4);
+
+    for (int i = 0; i < 100000; ++i) {
+        arr.emplace_at(i, i);
+        if (i % 3 == 0)
+            arr2.emplace_at(i, 0);
+    }
+    ecs::containers::zipper(arr, arr2).par_each(pool, [](int &component1, long &component2) {
+        component2 = component1 * 2;
+    });
+    for (int i = 0; i < 100000; ++i)
+        if (i % 3 == 0)
+            REQUIRE(*arr2[i] == i * 2);
+}
+
+struct sample {
+    float values[5];
+};
+
+TEST_CASE("zipper parallel iteration over tracked components", "[zipper]")
+{
+    ecs::containers::sparse_array<sample> arr;
+    ecs::thread_pool pool(8);
+    std::size_t changed = 0;
+
+    for (std::size_t i = 0; i < 200000; ++i)
+        arr.insert_at(i, sample{ { 1, 2, 3, 4, 5 } });
+    arr.track_changes(true);
+    arr.set_tick(5);
+    ecs::containers::zipper(arr).par_each(pool, [](sample &s) {
+        s.values[0] *= 2;
+    });
+    arr.each_change(5, [&changed](std::size_t, bool added) {
+        REQUIRE_FALSE(added);
+        changed++;
+    });
+    REQUIRE(changed == 200000);
+    REQUIRE(arr.get(199999).values[0] == 2);
+}
+
+TEST_CASE("zipper driven by the smallest container", "[zipper]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_set<long> set;
+    std::size_t n = 0;
+
+    for (int i = 0; i < 100000; ++i)
+        arr.emplace_at(i, i);
+    set.emplace_at(99999, 99999);
+    set.emplace_at(7, 7);
+    set.emplace_at(200000, 0);
+    for (auto &&[component1, component2] : ecs::containers::zipper(arr, set)) {
+        REQUIRE(component1 == component2);
+        n++;
+    }
+    REQUIRE(n == 2);
+    n = 0;
+    for (auto &&[component1, component2] : ecs::containers::zipper(set, arr)) {
+        REQUIRE(component1 == component2);
+        n++;
+    }
+    REQUIRE(n == 2);
+}
+
+TEST_CASE("zipper driven by a sparse_array", "[zipper]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_array<long> arr2;
+    std::size_t n = 0;
+
+    for (int i = 0; i < 5000; ++i)
+        arr.emplace_at(i, i);
+    arr2.emplace_at(4000, 4000);
+    arr2.emplace_at(10, 10);
+    arr2.emplace_at(9000, 0);
+    arr2.erase(9000);
+    REQUIRE(arr2.count() == 2);
+    for (auto &&[component1, component2] : ecs::containers::zipper(arr, arr2)) {
+        REQUIRE(component1 == component2);
+        n++;
+    }
+    REQUIRE(n == 2);
+}
+
+TEST_CASE("zipper intersects presence bitsets", "[zipper]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_array<long> arr2;
+    ecs::containers::sparse_array<char> arr3;
+    std::size_t expected = 0;
+    std::size_t n = 0;
+
+    for (int i = 0; i < 20000; ++i) {
+        if (i % 2 == 0)
+            arr.emplace_at(i, i);
+        if (i % 3 == 0)
+            arr2.emplace_at(i, i);
+        if (i < 3000 || i > 12000)
+            arr3.emplace_at(i, 'a');
+        if (i % 6 == 0 && (i < 3000 || i > 12000))
+            expected++;
+    }
+    arr3.erase(19998);
+    expected--;
+    for (auto &&[component1, component2, component3] : ecs::containers::zipper(arr, arr2, arr3)) {
+        REQUIRE(component1 % 6 == 0);
+        REQUIRE(component1 == component2);
+        REQUIRE(component3 == 'a');
+        n++;
+    }
+    REQUIRE(n == expected);
+}
+
+TEST_CASE("zipper walks the driver of a sparse join", "[zipper]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_array<long> arr2;
+    ecs::containers::sparse_array<char> arr3;
+    std::vector<int> seen;
+
+    for (int i = 0; i < 100000; ++i)
+        arr.emplace_at(i, i);
+    for (int i = 0; i < 100000; i += 10000)
+        arr2.emplace_at(i, i);
+    arr3.emplace_at(30000, 'a');
+    for (auto &&[component1, component2] : ecs::containers::zipper(arr, arr2, ecs::containers::exclude(arr3))) {
+        REQUIRE(component1 == component2);
+        seen.push_back(component1);
+    }
+    REQUIRE(seen == std::vector<int>{ 0, 10000, 20000, 40000, 50000, 60000, 70000, 80000, 90000 });
+}
+
+TEST_CASE("zipper over const containers", "[zipper]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_set<long> set;
+    auto const &constArr = arr;
+    int sum = 0;
+
+    for (int i = 0; i < 10; ++i) {
+        arr.emplace_at(i, i);
+        set.emplace_at(i, 1);
+    }
+    for (auto &&[component1, component2] : ecs::containers::zipper(constArr, set)) {
+        component2 = 2;
+        sum += component1;
+    }
+    REQUIRE(sum == 45);
+    REQUIRE(set[3] == 2);
+}
+
+TEST_CASE("zipper excludes containers", "[zipper]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_array<char> frozen;
+    ecs::containers::sparse_set<char> hidden;
+    std::size_t n = 0;
+    long sum = 0;
+
+    for (int i = 0; i < 1000; ++i)
+        arr.emplace_at(i, i);
+    for (int i = 0; i < 300; i += 2)
+        frozen.emplace_at(i, 'f');
+    for (int i = 0; i < 1000; i += 3)
+        hidden.emplace_at(i, 'h');
+    for (auto &&[component] : ecs::containers::zipper(arr, ecs::containers::exclude(frozen))) {
+        REQUIRE((component >= 300 || component % 2 == 1));
+        ++n;
+    }
+    REQUIRE(n == 850);
+    for (auto &&[index, component] :
+        ecs::containers::indexed_zipper(arr, ecs::containers::exclude(frozen), ecs::containers::exclude(hidden))) {
+        REQUIRE(index % 3 != 0);
+        REQUIRE((index >= 300 || index % 2 == 1));
+        sum += component;
+    }
+
+    long expected = 0;
+
+    for (int i = 0; i < 1000; ++i)
+        if (i % 3 != 0 && (i >= 300 || i % 2 == 1))
+            expected += i;
+    REQUIRE(sum == expected);
+}
+
+TEST_CASE("zipper returns optional components", "[zipper]")
+{
+    ecs::containers::sparse_array<int> arr;
+    ecs::containers::sparse_set<long> set;
+    int found = 0;
+    int missing = 0;
+
+    for (int i = 0; i < 10; ++i)
+        arr.emplace_at(i, i);
+    set.emplace_at(4, 40);
+    set.emplace_at(20, 200);
+    for (auto &&[component, optional] : ecs::containers::zipper(arr, ecs::containers::maybe(set))) {
+        if (optional) {
+            REQUIRE(*optional == component * 10);
+            *optional = 0;
+            ++found;
+        } else {
+            ++missing;
+        }
+    }
+    REQUIRE(found == 1);
+    REQUIRE(missing == 9);
+    REQUIRE(set[4] == 0);
+}